@@ -14,6 +14,9 @@
 
 #include "game/resource_manager.h"
 
+#include <algorithm>
+#include <vector>
+
 #include <nucleus/logging.h>
 
 #include "resources/sfml_loaders.h"
@@ -31,6 +34,13 @@ static const struct {
     {ResourceManager::Texture::Asteroid3, "images\\objects\\asteroid_3.png"},
 };
 
+// Space left around each texture in the atlas so that smoothing doesn't bleed
+// neighbouring textures into each other.
+const unsigned kAtlasPadding = 2;
+
+// The widest we make the atlas before starting a new row.
+const unsigned kMaxAtlasWidth = 2048;
+
 }  // namespace
 
 ResourceManager::ResourceManager() {
@@ -46,15 +56,20 @@ bool ResourceManager::loadAll(const std::string& root) {
     return false;
   }
 
+  std::map<Texture, sf::Image> images;
   for (size_t i = 0; i < ARRAY_SIZE(kTextures); ++i) {
-    if (!m_textureStore.load(kTextures[i].texture,
-                             loaders::fromFile<sf::Texture>(
-                                 root + std::string(kTextures[i].filename)))) {
+    sf::Image& image = images[kTextures[i].texture];
+    if (!image.loadFromFile(root + std::string(kTextures[i].filename))) {
       LOG(Error) << "Could not load texture. (" << kTextures[i].filename << ")";
       return false;
     }
   }
 
+  if (!buildAtlas(images)) {
+    LOG(Error) << "Could not build the texture atlas.";
+    return false;
+  }
+
   return true;
 }
 
@@ -62,6 +77,71 @@ sf::Font* ResourceManager::getFont(Font font) {
   return m_fontStore.get(font);
 }
 
-sf::Texture* ResourceManager::getTexture(Texture texture) {
-  return m_textureStore.get(texture);
+sf::IntRect ResourceManager::getAtlasRect(Texture texture) const {
+  auto it = m_atlasRects.find(texture);
+  if (it == std::end(m_atlasRects)) {
+    return sf::IntRect{};
+  }
+  return it->second;
+}
+
+bool ResourceManager::buildAtlas(const std::map<Texture, sf::Image>& images) {
+  // Place the tallest images first so that each row wastes as little space
+  // as possible.
+  std::vector<Texture> order;
+  for (const auto& image : images) {
+    order.push_back(image.first);
+  }
+  std::sort(std::begin(order), std::end(order),
+            [&images](Texture left, Texture right) {
+              return images.at(left).getSize().y > images.at(right).getSize().y;
+            });
+
+  // Lay the images out in rows from left to right.
+  unsigned x = 0;
+  unsigned y = 0;
+  unsigned rowHeight = 0;
+  unsigned atlasWidth = 0;
+  m_atlasRects.clear();
+  for (const auto& texture : order) {
+    const sf::Vector2u size = images.at(texture).getSize();
+
+    if (x > 0 && x + size.x + kAtlasPadding > kMaxAtlasWidth) {
+      x = 0;
+      y += rowHeight;
+      rowHeight = 0;
+    }
+
+    m_atlasRects[texture] =
+        sf::IntRect{static_cast<int>(x + kAtlasPadding),
+                    static_cast<int>(y + kAtlasPadding),
+                    static_cast<int>(size.x), static_cast<int>(size.y)};
+
+    x += size.x + kAtlasPadding * 2;
+    rowHeight = std::max(rowHeight, size.y + kAtlasPadding * 2);
+    atlasWidth = std::max(atlasWidth, x);
+  }
+  const unsigned atlasHeight = y + rowHeight;
+
+  if (atlasWidth > sf::Texture::getMaximumSize() ||
+      atlasHeight > sf::Texture::getMaximumSize()) {
+    LOG(Error) << "Texture atlas is too large. (" << atlasWidth << "x"
+               << atlasHeight << ")";
+    return false;
+  }
+
+  // Copy all the images into their places.
+  sf::Image atlas;
+  atlas.create(atlasWidth, atlasHeight, sf::Color{0, 0, 0, 0});
+  for (const auto& rect : m_atlasRects) {
+    atlas.copy(images.at(rect.first), static_cast<unsigned>(rect.second.left),
+               static_cast<unsigned>(rect.second.top));
+  }
+
+  if (!m_atlasTexture.loadFromImage(atlas)) {
+    return false;
+  }
+  m_atlasTexture.setSmooth(true);
+
+  return true;
 }
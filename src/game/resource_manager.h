@@ -15,9 +15,14 @@
 #ifndef GAME_RESOURCE_MANAGER_H_
 #define GAME_RESOURCE_MANAGER_H_
 
+#include <map>
+
 #include <elastic/resources/resource_store.h>
 #include <nucleus/macros.h>
 #include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Texture.hpp>
 
 class ResourceManager {
 public:
@@ -41,12 +46,24 @@ public:
   // Return the requested font.
   sf::Font* getFont(Font font);
 
-  // Return the requested texture.
-  sf::Texture* getTexture(Texture texture);
+  // Return the texture that all the object textures are packed into.  Objects
+  // that draw from the same texture can be drawn together in a single call.
+  sf::Texture* getAtlasTexture() { return &m_atlasTexture; }
+
+  // Return the area of the atlas texture that holds the requested texture.
+  sf::IntRect getAtlasRect(Texture texture) const;
 
 private:
+  // Pack all the images into the atlas texture.
+  bool buildAtlas(const std::map<Texture, sf::Image>& images);
+
   el::ResourceStore<sf::Font, Font> m_fontStore;
-  el::ResourceStore<sf::Texture, Texture> m_textureStore;
+
+  // All the object textures packed together.
+  sf::Texture m_atlasTexture;
+
+  // Where each texture is in the atlas.
+  std::map<Texture, sf::IntRect> m_atlasRects;
 
   DISALLOW_COPY_AND_ASSIGN(ResourceManager);
 };
@@ -14,6 +14,8 @@
 
 #include "game_states/game_state_universe.h"
 
+#include <thread>
+
 #include <elastic/views/button_view.h>
 #include <elastic/views/linear_sizer_view.h>
 #include <SFML/Graphics/RenderTarget.hpp>
@@ -38,9 +40,18 @@ std::string buttonLabelForObject() {
 }  // namespace
 
 GameStateUniverse::GameStateUniverse(ResourceManager* resourceManager,
-                                     el::Context* context)
+                                     el::Context* context,
+                                     float ticksPerSecond, uint64_t seed)
   : GameState(context),
-    m_universe(std::make_unique<Universe>(resourceManager)) {
+    m_universe(std::make_unique<Universe>(resourceManager, seed)),
+    m_timestep(ticksPerSecond) {
+  // Tick the objects on all the cores we have.
+  m_universe->setThreadCount(std::thread::hardware_concurrency());
+
+  m_commandLog.setSeed(seed);
+  m_commandLog.setAdjustment(m_timestep.getStepAdjustment());
+  m_universe->setCommandLog(&m_commandLog);
+
   // Add the user interface to the UI tree.
   createUserInterface(m_uiContext, m_uiContext->getRoot());
 }
@@ -51,8 +62,14 @@ GameStateUniverse::~GameStateUniverse() {
 void GameStateUniverse::tick(float adjustment) {
   GameState::tick(adjustment);
 
-  // Forward the tick to the universe as well.
-  m_universe->tick(adjustment);
+  // The universe always ticks in fixed steps so that it behaves the same at
+  // any frame rate.  The view draws the objects part of the way to their
+  // next positions with whatever time is left over.
+  const size_t steps = m_timestep.advance(adjustment);
+  for (size_t i = 0; i < steps; ++i) {
+    m_universe->tick(m_timestep.getStepAdjustment());
+  }
+  m_universeView->setInterpolation(m_timestep.getInterpolation());
 
   // Update the total power label.
   m_totalPowerText->setLabel(std::to_string(m_universe->getPower()));
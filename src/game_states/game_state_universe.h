@@ -21,17 +21,24 @@
 #include <elastic/views/text_view.h>
 
 #include "game_states/game_state.h"
+#include "universe/command_log.h"
 #include "universe/universe.h"
+#include "utils/fixed_timestep.h"
 
 class UniverseView;
 
 class GameStateUniverse : public GameState,
                           public el::ButtonView::OnClickListener {
 public:
-  explicit GameStateUniverse(ResourceManager* resourceManager,
-                             el::Context* context);
+  // The universe is ticked ticksPerSecond times per second, regardless of
+  // the frame rate.  The same seed creates the same universe.
+  GameStateUniverse(ResourceManager* resourceManager, el::Context* context,
+                    float ticksPerSecond, uint64_t seed);
   virtual ~GameStateUniverse() override;
 
+  // Return the log of everything placed in the universe so far.
+  const CommandLog& getCommandLog() const { return m_commandLog; }
+
   // Override: GameState
   void tick(float adjustment) override;
 
@@ -45,6 +52,13 @@ private:
   // The universe for this game state.
   std::unique_ptr<Universe> m_universe;
 
+  // Splits the time between frames into universe ticks.
+  FixedTimestep m_timestep;
+
+  // Records everything placed in the universe so that the game can be
+  // replayed.
+  CommandLog m_commandLog;
+
   // Mapped UI controls.
   UniverseView* m_universeView{nullptr};
   el::ButtonView* m_createPowerGeneratorButton{nullptr};
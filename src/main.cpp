@@ -12,8 +12,10 @@
 // OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
 // PERFORMANCE OF THIS SOFTWARE.
 
-#include <cstdlib>
 #include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <string>
 
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Window/Event.hpp>
@@ -23,11 +25,33 @@
 #include "game/ui_context.h"
 #include "game_states/game_state_universe.h"
 
-int main() {
+namespace {
+
+// The number of times per second the universe is ticked.  Lower this on
+// heavy maps; rendering still happens at the display rate.
+const float kSimulationTicksPerSecond = 60.f;
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
   LOG(Info) << "Starting SpaceGame";
 
-  // Seed the random number generator.
-  std::srand(static_cast<unsigned int>(std::time(nullptr)));
+  // With --record=<path> everything placed in the universe is written to a
+  // command log when the game closes, so that it can be replayed with
+  // SpaceGameSim.
+  std::string recordPath;
+  const std::string kRecordArgument{"--record="};
+  for (int i = 1; i < argc; ++i) {
+    std::string arg{argv[i]};
+    if (arg.compare(0, kRecordArgument.size(), kRecordArgument) == 0) {
+      recordPath = arg.substr(kRecordArgument.size());
+    }
+  }
+
+  // Every game gets a new universe.  Log the seed so that a game can be
+  // recreated.
+  const uint64_t seed = static_cast<uint64_t>(std::time(nullptr));
+  LOG(Info) << "Universe seed: " << seed;
 
   sf::ContextSettings settings{32, 0, 4};
   sf::RenderWindow window{sf::VideoMode{1600, 900, 32}, "SpaceGame",
@@ -45,8 +69,8 @@ int main() {
   auto context = std::make_unique<UiContext>(&resourceManager);
 
   // Construct the universe game state.
-  std::unique_ptr<GameState> gameState =
-      std::make_unique<GameStateUniverse>(&resourceManager, context.get());
+  auto gameState = std::make_unique<GameStateUniverse>(
+      &resourceManager, context.get(), kSimulationTicksPerSecond, seed);
 
   using Clock = std::chrono::high_resolution_clock;
   auto lastTick = Clock::now();
@@ -70,7 +94,8 @@ int main() {
         std::chrono::duration_cast<std::chrono::microseconds>(now - lastTick);
     lastTick = now;
 
-    // We calculate the adjust we must make to get a smooth 60fps tick.
+    // We calculate the adjust we must make to get a smooth 60fps tick.  The
+    // game state splits it into fixed simulation steps.
     float adjustment = timePassed.count() * 60.f / 1000.f;
     gameState->tick(adjustment);
 
@@ -83,5 +108,9 @@ int main() {
     window.display();
   }
 
+  if (!recordPath.empty()) {
+    gameState->getCommandLog().saveToFile(recordPath);
+  }
+
   return 0;
 }
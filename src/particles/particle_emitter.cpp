@@ -14,15 +14,45 @@
 
 #include "particles/particle_emitter.h"
 
-#include <SFML/Graphics/RenderTarget.hpp>
+#include <cmath>
 
-#include "particles/particle.h"
+#include "particles/particle_system.h"
+#include "utils/vertex_builder.h"
 
-ParticleEmitter::ParticleEmitter(const ParticleFactory& factory)
-  : m_factory(factory) {
+namespace {
+
+// The number of triangles we use to draw each particle.
+const size_t kSegmentCount = 12;
+
+// The number of particles we expect an emitter to keep alive at once.
+const size_t kInitialCapacity = 32;
+
+}  // namespace
+
+// static
+std::atomic<size_t> ParticleEmitter::s_totalParticleCount{0};
+
+// static
+std::atomic<size_t> ParticleEmitter::s_totalMemoryUsage{0};
+
+ParticleEmitter::ParticleEmitter(ParticleSystem* system,
+                                 const Settings& settings)
+  : m_system(system), m_settings(settings) {
+  m_posX.reserve(kInitialCapacity);
+  m_posY.reserve(kInitialCapacity);
+  m_life.reserve(kInitialCapacity);
+  m_alpha.reserve(kInitialCapacity);
+  m_radius.reserve(kInitialCapacity);
+  updateMemoryUsage();
+
+  m_system->addEmitter(this);
 }
 
 ParticleEmitter::~ParticleEmitter() {
+  m_system->removeEmitter(this);
+
+  s_totalParticleCount -= m_life.size();
+  s_totalMemoryUsage -= m_memoryUsage;
 }
 
 void ParticleEmitter::setPos(const sf::Vector2f& pos) {
@@ -31,33 +61,80 @@ void ParticleEmitter::setPos(const sf::Vector2f& pos) {
 
 void ParticleEmitter::tick(float adjustment) {
   // Emit a particle every few moments.
-  if (m_timeSinceLastParticle > 1.f) {
+  if (m_timeSinceLastParticle > m_settings.emitInterval) {
     createParticle(m_pos);
     m_timeSinceLastParticle = 0.f;
   } else {
     m_timeSinceLastParticle += adjustment;
   }
 
-  // Tick all the particles.
-  for (auto& particle : m_particles) {
-    particle->tick(adjustment);
+  // Fade and shrink all the particles according to how much life they have
+  // left.
+  const size_t count = m_life.size();
+  for (size_t i = 0; i < count; ++i) {
+    float ratio = m_life[i] / m_settings.lifeTime;
+    m_alpha[i] = static_cast<sf::Uint8>(
+        std::round(static_cast<float>(m_settings.color.a) * ratio));
+    m_radius[i] = m_settings.radius * ratio;
+    m_life[i] -= adjustment;
   }
 
-  // Remove all the dead particles.
-  m_particles.erase(
-      std::remove_if(std::begin(m_particles), std::end(m_particles),
-                     [](Particle* p) { return p->isDead(); }),
-      std::end(m_particles));
+  // Remove all the dead particles.  We walk backwards so that the particle
+  // swapped into a removed slot has already been checked.
+  for (size_t i = m_life.size(); i > 0; --i) {
+    if (m_life[i - 1] <= 0.f) {
+      removeParticle(i - 1);
+    }
+  }
 }
 
-void ParticleEmitter::draw(sf::RenderTarget& target,
-                           sf::RenderStates states) const {
-  for (const auto& particle : m_particles) {
-    target.draw(*particle, states);
+void ParticleEmitter::appendVertices(sf::VertexArray* vertices) const {
+  const size_t count = m_life.size();
+  for (size_t i = 0; i < count; ++i) {
+    sf::Color color{m_settings.color};
+    color.a = m_alpha[i];
+    appendCircle(sf::Vector2f{m_posX[i], m_posY[i]}, m_radius[i], color,
+                 vertices, kSegmentCount);
   }
 }
 
 void ParticleEmitter::createParticle(const sf::Vector2f& pos) {
-  Particle* p = m_factory(this, pos);
-  m_particles.push_back(p);
+  m_posX.push_back(pos.x);
+  m_posY.push_back(pos.y);
+  m_life.push_back(m_settings.lifeTime);
+  m_alpha.push_back(m_settings.color.a);
+  m_radius.push_back(m_settings.radius);
+
+  ++s_totalParticleCount;
+  updateMemoryUsage();
+}
+
+void ParticleEmitter::removeParticle(size_t index) {
+  const size_t last = m_life.size() - 1;
+  if (index != last) {
+    m_posX[index] = m_posX[last];
+    m_posY[index] = m_posY[last];
+    m_life[index] = m_life[last];
+    m_alpha[index] = m_alpha[last];
+    m_radius[index] = m_radius[last];
+  }
+
+  m_posX.pop_back();
+  m_posY.pop_back();
+  m_life.pop_back();
+  m_alpha.pop_back();
+  m_radius.pop_back();
+
+  --s_totalParticleCount;
+}
+
+void ParticleEmitter::updateMemoryUsage() {
+  size_t memoryUsage = m_posX.capacity() * sizeof(float) +
+                       m_posY.capacity() * sizeof(float) +
+                       m_life.capacity() * sizeof(float) +
+                       m_alpha.capacity() * sizeof(sf::Uint8) +
+                       m_radius.capacity() * sizeof(float);
+
+  s_totalMemoryUsage += memoryUsage - m_memoryUsage;
+  m_memoryUsage = memoryUsage;
 }
@@ -15,38 +15,92 @@
 #ifndef PARTICLES_PARTICLE_EMITTER_H_
 #define PARTICLES_PARTICLE_EMITTER_H_
 
-#include <functional>
+#include <atomic>
+#include <cstdint>
 #include <vector>
 
 #include <nucleus/macros.h>
-#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
 
-class Particle;
+class ParticleSystem;
 
-class ParticleEmitter : public sf::Drawable {
+// Emits particles at its position and keeps them alive until they fade out.
+// The particles are stored as a structure of arrays and dead particles are
+// swapped out with the last live one, so the emitter doesn't allocate anything
+// once its arrays have grown to the number of particles it keeps alive.  The
+// particles are drawn by the ParticleSystem the emitter belongs to.
+class ParticleEmitter {
 public:
-  using ParticleFactory =
-      std::function<Particle*(ParticleEmitter*, const sf::Vector2f&)>;
+  // Describes the particles an emitter creates.
+  struct Settings {
+    // The time between particles being emitted.
+    float emitInterval{1.f};
 
-  explicit ParticleEmitter(const ParticleFactory& factory);
+    // The number of ticks a particle stays alive.
+    float lifeTime{20.f};
+
+    // The radius a particle starts out with.  It shrinks to nothing over its
+    // lifetime.
+    float radius{15.f};
+
+    // The color a particle starts out with.  It fades out over its lifetime.
+    sf::Color color{255, 255, 255};
+  };
+
+  // Return the number of live particles over all emitters.
+  static size_t getTotalParticleCount() { return s_totalParticleCount; }
+
+  // Return the number of bytes reserved for particles over all emitters.
+  static size_t getTotalMemoryUsage() { return s_totalMemoryUsage; }
+
+  // The emitter adds itself to the system and removes itself again when it is
+  // destroyed.
+  ParticleEmitter(ParticleSystem* system, const Settings& settings);
   ~ParticleEmitter();
 
   // Get/set our position.
   const sf::Vector2f& getPos() const { return m_pos; }
   void setPos(const sf::Vector2f& pos);
 
+  // Return the number of particles that are alive.
+  size_t getParticleCount() const { return m_life.size(); }
+
   // Tick the emitter.
   void tick(float adjustment);
 
-  // Override: sf::Drawable
-  void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+  // Add the geometry of all the live particles to the vertex array as
+  // triangles.
+  void appendVertices(sf::VertexArray* vertices) const;
 
 private:
+  friend class ParticleSystem;
+
   // Creates a new particle and add it to our list of particles.
   void createParticle(const sf::Vector2f& pos);
-  
-  // The factory function we use to create particles.
-  ParticleFactory m_factory;
+
+  // Remove the particle at the given index by moving the last particle into
+  // its place.
+  void removeParticle(size_t index);
+
+  // Update the memory usage counters after the arrays might have grown.
+  void updateMemoryUsage();
+
+  // The number of live particles over all emitters.  Emitters are ticked from
+  // multiple threads, so the counters are atomic.
+  static std::atomic<size_t> s_totalParticleCount;
+
+  // The number of bytes reserved for particles over all emitters.
+  static std::atomic<size_t> s_totalMemoryUsage;
+
+  // The system that draws our particles.
+  ParticleSystem* m_system;
+
+  // Our index in the system's list of emitters.
+  size_t m_systemIndex{0};
+
+  // The particles we create.
+  Settings m_settings;
 
   // Our position.
   sf::Vector2f m_pos;
@@ -54,8 +108,15 @@ private:
   // The time since the last particle was emitted.
   float m_timeSinceLastParticle{0.f};
 
-  // All the particles we are rendering.
-  std::vector<Particle*> m_particles;
+  // The state of each live particle.
+  std::vector<float> m_posX;
+  std::vector<float> m_posY;
+  std::vector<float> m_life;
+  std::vector<sf::Uint8> m_alpha;
+  std::vector<float> m_radius;
+
+  // The number of bytes reserved by our arrays.
+  size_t m_memoryUsage{0};
 
   DISALLOW_COPY_AND_ASSIGN(ParticleEmitter);
 };
@@ -0,0 +1,56 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#include "particles/particle_system.h"
+
+#include <nucleus/logging.h>
+#include <SFML/Graphics/RenderTarget.hpp>
+
+#include "particles/particle_emitter.h"
+
+ParticleSystem::ParticleSystem() : m_vertices(sf::Triangles) {
+}
+
+ParticleSystem::~ParticleSystem() {
+}
+
+void ParticleSystem::addEmitter(ParticleEmitter* emitter) {
+  emitter->m_systemIndex = m_emitters.size();
+  m_emitters.push_back(emitter);
+}
+
+void ParticleSystem::removeEmitter(ParticleEmitter* emitter) {
+  const size_t index = emitter->m_systemIndex;
+  if (index >= m_emitters.size() || m_emitters[index] != emitter) {
+    LOG(Error) << "Trying to remove emitter that is not in the system!";
+    return;
+  }
+
+  // Move the last emitter into the free spot.
+  m_emitters[index] = m_emitters.back();
+  m_emitters[index]->m_systemIndex = index;
+  m_emitters.pop_back();
+}
+
+void ParticleSystem::draw(sf::RenderTarget& target,
+                          sf::RenderStates states) const {
+  m_vertices.clear();
+  for (const auto& emitter : m_emitters) {
+    emitter->appendVertices(&m_vertices);
+  }
+
+  if (m_vertices.getVertexCount() > 0) {
+    target.draw(m_vertices, states);
+  }
+}
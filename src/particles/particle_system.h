@@ -12,50 +12,43 @@
 // OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
 // PERFORMANCE OF THIS SOFTWARE.
 
-#ifndef PARTICLES_PARTICLE_H_
-#define PARTICLES_PARTICLE_H_
+#ifndef PARTICLES_PARTICLE_SYSTEM_H_
+#define PARTICLES_PARTICLE_SYSTEM_H_
+
+#include <vector>
 
 #include <nucleus/macros.h>
-#include <SFML/Graphics/CircleShape.hpp>
 #include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
 
 class ParticleEmitter;
 
-class Particle : public sf::Drawable {
+// Keeps track of all the particle emitters so that all of their particles can
+// be drawn with a single draw call.  Emitters add and remove themselves.
+class ParticleSystem : public sf::Drawable {
 public:
-  Particle(ParticleEmitter* emitter, const sf::Vector2f& pos);
-  ~Particle();
-
-  // Get/set position.
-  const sf::Vector2f& getPos() const { return m_pos; }
-  void setPos(const sf::Vector2f& pos);
+  ParticleSystem();
+  ~ParticleSystem();
 
-  // Returns true if the particle is dead and should be removed.
-  bool isDead() const { return m_life <= 0; }
+  // Return the number of emitters in the system.
+  size_t getEmitterCount() const { return m_emitters.size(); }
 
-  // Tick the particle.
-  virtual void tick(float adjustment);
+  // Add or remove an emitter.
+  void addEmitter(ParticleEmitter* emitter);
+  void removeEmitter(ParticleEmitter* emitter);
 
   // Override: sf::Drawable
   void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
 private:
-  // The emitter that created us.
-  ParticleEmitter* m_emitter;
-
-  // Our position.
-  sf::Vector2f m_pos;
-
-  // The lifetime of the particle.
-  float m_lifeTime{100.f};
-
-  // The current life of the particle.
-  float m_life{m_lifeTime};
+  // All the emitters in the system.
+  std::vector<ParticleEmitter*> m_emitters;
 
-  // The shape we use to render the particle.
-  sf::CircleShape m_shape;
+  // The vertices of all the live particles.  Rebuilt every frame, but kept
+  // around so that we don't allocate every frame.
+  mutable sf::VertexArray m_vertices;
 
-  DISALLOW_IMPLICIT_CONSTRUCTORS(Particle);
+  DISALLOW_COPY_AND_ASSIGN(ParticleSystem);
 };
 
-#endif  // PARTICLES_PARTICLE_H_
+#endif  // PARTICLES_PARTICLE_SYSTEM_H_
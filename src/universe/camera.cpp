@@ -29,6 +29,11 @@ Camera::Camera() {
 Camera::~Camera() {
 }
 
+sf::FloatRect Camera::getViewRect() const {
+  const sf::Vector2f& size = m_view.getSize();
+  return sf::FloatRect{m_view.getCenter() - size / 2.f, size};
+}
+
 sf::Vector2f Camera::mousePosToUniversePos(const sf::Vector2i& mousePos) const {
   const float width = static_cast<float>(m_viewportSize.x);
   const float height = static_cast<float>(m_viewportSize.y);
@@ -38,6 +38,9 @@ public:
   // Return our current view.
   const sf::View& getView() const { return m_view; }
 
+  // Return the area of the universe that is visible through the camera.
+  sf::FloatRect getViewRect() const;
+
   // Given a mouse position in the viewport, return the universe position.
   sf::Vector2f mousePosToUniversePos(const sf::Vector2i& mousePos) const;
 
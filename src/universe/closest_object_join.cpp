@@ -0,0 +1,104 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#include "universe/closest_object_join.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "universe/objects/object.h"
+
+ClosestObjectJoin::ClosestObjectJoin() {
+}
+
+ClosestObjectJoin::~ClosestObjectJoin() {
+}
+
+void ClosestObjectJoin::run(const std::vector<Object*>& objects,
+                            const std::vector<sf::Vector2f>& positions,
+                            float maxRange, std::vector<Object*>* closestOut) {
+  closestOut->assign(positions.size(), nullptr);
+  if (objects.empty() || positions.empty()) {
+    return;
+  }
+
+  // Blocks have to be at least as wide as the range for the 3x3 blocks around
+  // a position to cover it.  An unlimited range puts everything into the
+  // blocks around the origin.
+  const float blockSize = maxRange;
+
+  m_entries.clear();
+  m_entries.reserve(objects.size());
+  for (size_t i = 0; i < objects.size(); ++i) {
+    const sf::Vector2f& pos = objects[i]->getPos();
+    m_entries.push_back(Entry{keyFor(blockCoordFor(pos.x, blockSize),
+                                     blockCoordFor(pos.y, blockSize)),
+                              pos, objects[i], static_cast<uint32_t>(i)});
+  }
+  std::sort(std::begin(m_entries), std::end(m_entries),
+            [](const Entry& left, const Entry& right) {
+              return left.key < right.key ||
+                     (left.key == right.key && left.order < right.order);
+            });
+
+  const float maxRangeSquared = maxRange * maxRange;
+
+  for (size_t i = 0; i < positions.size(); ++i) {
+    const sf::Vector2f& pos = positions[i];
+    const int32_t blockX = blockCoordFor(pos.x, blockSize);
+    const int32_t blockY = blockCoordFor(pos.y, blockSize);
+
+    const Entry* closest = nullptr;
+    float closestDistanceSquared = maxRangeSquared;
+
+    for (int32_t y = blockY - 1; y <= blockY + 1; ++y) {
+      for (int32_t x = blockX - 1; x <= blockX + 1; ++x) {
+        const BlockKey key = keyFor(x, y);
+        auto entry = std::lower_bound(
+            std::begin(m_entries), std::end(m_entries), key,
+            [](const Entry& entry, BlockKey key) { return entry.key < key; });
+        for (; entry != std::end(m_entries) && entry->key == key; ++entry) {
+          const sf::Vector2f delta = entry->pos - pos;
+          const float distanceSquared = delta.x * delta.x + delta.y * delta.y;
+          if (distanceSquared < closestDistanceSquared ||
+              (distanceSquared == closestDistanceSquared &&
+               (!closest || entry->order < closest->order))) {
+            closest = &*entry;
+            closestDistanceSquared = distanceSquared;
+          }
+        }
+      }
+    }
+
+    if (closest) {
+      (*closestOut)[i] = closest->object;
+    }
+  }
+}
+
+// static
+ClosestObjectJoin::BlockKey ClosestObjectJoin::keyFor(int32_t x, int32_t y) {
+  return (static_cast<BlockKey>(static_cast<uint32_t>(x)) << 32) |
+         static_cast<uint32_t>(y);
+}
+
+// static
+int32_t ClosestObjectJoin::blockCoordFor(float value, float blockSize) {
+  // Keep the coordinate away from the limits, so that the blocks around it
+  // don't wrap around.
+  const float kLimit = static_cast<float>(1 << 30);
+  return static_cast<int32_t>(
+      std::max(-kLimit, std::min(std::floor(value / blockSize), kLimit)));
+}
@@ -0,0 +1,66 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#ifndef UNIVERSE_CLOSEST_OBJECT_JOIN_H_
+#define UNIVERSE_CLOSEST_OBJECT_JOIN_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <nucleus/macros.h>
+#include <SFML/System/Vector2.hpp>
+
+class Object;
+
+// Finds the closest of a set of objects for many positions at once.  The
+// objects are filed into square blocks as wide as the search range, so every
+// position only has to look at the objects in the 3x3 blocks around it, and
+// the cost of filing the objects is shared by all the positions.
+class ClosestObjectJoin {
+public:
+  ClosestObjectJoin();
+  ~ClosestObjectJoin();
+
+  // Set closestOut to the closest object within maxRange of each of the
+  // positions, or null if there is none.  Objects at the same distance are
+  // decided by their order in objects.
+  void run(const std::vector<Object*>& objects,
+           const std::vector<sf::Vector2f>& positions, float maxRange,
+           std::vector<Object*>* closestOut);
+
+private:
+  using BlockKey = uint64_t;
+
+  struct Entry {
+    BlockKey key;
+    sf::Vector2f pos;
+    Object* object;
+
+    // The order of the object in the list we were given.
+    uint32_t order;
+  };
+
+  // Return the key of the block at the given block coordinates.
+  static BlockKey keyFor(int32_t x, int32_t y);
+
+  // Return the block coordinate of value for blocks of the given size.
+  static int32_t blockCoordFor(float value, float blockSize);
+
+  // The objects sorted by block.  Kept around so that the memory is reused.
+  std::vector<Entry> m_entries;
+
+  DISALLOW_COPY_AND_ASSIGN(ClosestObjectJoin);
+};
+
+#endif  // UNIVERSE_CLOSEST_OBJECT_JOIN_H_
@@ -0,0 +1,164 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#include "universe/command_buffer.h"
+
+#include <utility>
+
+#include "universe/objects/projectiles/projectile.h"
+#include "universe/objects/structures/turret.h"
+#include "universe/universe.h"
+
+CommandBuffer::CommandBuffer() {
+}
+
+CommandBuffer::~CommandBuffer() {
+}
+
+void CommandBuffer::moveObject(Object* object, const sf::Vector2f& pos) {
+  Command& command = record(CommandType::Move);
+  command.object = object;
+  command.pos = pos;
+}
+
+void CommandBuffer::removeObject(Object* object) {
+  record(CommandType::Remove).object = object;
+}
+
+void CommandBuffer::watchObject(const ObjectHandle& object, Object* watcher) {
+  Command& command = record(CommandType::Watch);
+  command.object = watcher;
+  command.handle = object;
+}
+
+void CommandBuffer::unwatchObject(const ObjectHandle& object,
+                                  Object* watcher) {
+  Command& command = record(CommandType::Unwatch);
+  command.object = watcher;
+  command.handle = object;
+}
+
+void CommandBuffer::spawnBullet(const sf::Vector2f& pos, float direction,
+                                float speed) {
+  Command& command = record(CommandType::Spawn);
+  command.pos = pos;
+  command.direction = direction;
+  command.speed = speed;
+}
+
+void CommandBuffer::mineAsteroid(const ObjectHandle& asteroid,
+                                 int32_t amount) {
+  Command& command = record(CommandType::Mine);
+  command.handle = asteroid;
+  command.amount = amount;
+}
+
+void CommandBuffer::placeRailMissiles(Turret* turret) {
+  record(CommandType::PlaceRail).object = turret;
+}
+
+void CommandBuffer::launchMissile(Turret* turret, const ObjectHandle& target) {
+  Command& command = record(CommandType::Launch);
+  command.object = turret;
+  command.handle = target;
+}
+
+void CommandBuffer::setProjectileVelocity(Projectile* projectile,
+                                          const sf::Vector2f& velocity) {
+  Command& command = record(CommandType::SetVelocity);
+  command.object = projectile;
+  command.pos = velocity;
+}
+
+void CommandBuffer::setProjectileCollisionTypes(Projectile* projectile,
+                                                uint32_t typeMask) {
+  Command& command = record(CommandType::SetCollisionTypes);
+  command.object = projectile;
+  command.typeMask = typeMask;
+}
+
+void CommandBuffer::adjustMinerals(int32_t amount) {
+  m_minerals += amount;
+}
+
+void CommandBuffer::defer(std::function<void()> function) {
+  record(CommandType::Deferred).deferredIndex = m_deferred.size();
+  m_deferred.push_back(std::move(function));
+}
+
+void CommandBuffer::apply(Universe* universe) {
+  // Objects are only deleted once the tick is done, so all the objects that
+  // were recorded are still alive here.
+  for (const auto& command : m_commands) {
+    switch (command.type) {
+      case CommandType::Move:
+        universe->moveObject(command.object, command.pos);
+        break;
+
+      case CommandType::Remove:
+        universe->removeObject(command.object);
+        break;
+
+      case CommandType::Watch:
+        universe->watchObject(command.handle, command.object);
+        break;
+
+      case CommandType::Unwatch:
+        universe->unwatchObject(command.handle, command.object);
+        break;
+
+      case CommandType::Spawn:
+        universe->spawnBullet(command.pos, command.direction, command.speed);
+        break;
+
+      case CommandType::Mine:
+        universe->mineAsteroid(command.handle, command.amount);
+        break;
+
+      case CommandType::PlaceRail:
+        universe->placeRailMissiles(static_cast<Turret*>(command.object));
+        break;
+
+      case CommandType::Launch:
+        universe->launchMissile(static_cast<Turret*>(command.object),
+                                command.handle);
+        break;
+
+      case CommandType::SetVelocity:
+        universe->setProjectileVelocity(
+            static_cast<Projectile*>(command.object), command.pos);
+        break;
+
+      case CommandType::SetCollisionTypes:
+        universe->setProjectileCollisionTypes(
+            static_cast<Projectile*>(command.object), command.typeMask);
+        break;
+
+      case CommandType::Deferred:
+        m_deferred[command.deferredIndex]();
+        break;
+    }
+  }
+  m_commands.clear();
+  m_deferred.clear();
+
+  universe->adjustMinerals(m_minerals);
+  m_minerals = 0;
+}
+
+CommandBuffer::Command& CommandBuffer::record(CommandType type) {
+  m_commands.emplace_back();
+  m_commands.back().type = type;
+  return m_commands.back();
+}
@@ -0,0 +1,128 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#ifndef UNIVERSE_COMMAND_BUFFER_H_
+#define UNIVERSE_COMMAND_BUFFER_H_
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <nucleus/macros.h>
+#include <SFML/System/Vector2.hpp>
+
+#include "universe/object_handle.h"
+
+class Object;
+class Projectile;
+class Turret;
+class Universe;
+
+// Records the changes objects want to make to the universe while they are
+// being ticked in parallel.  Nothing is changed until the buffer is applied,
+// so every object sees the universe as it was at the start of the tick.
+class CommandBuffer {
+public:
+  CommandBuffer();
+  ~CommandBuffer();
+
+  // Return true if nothing was recorded.
+  bool isEmpty() const {
+    return m_commands.empty() && !m_minerals;
+  }
+
+  // See the Universe functions with the same names.
+  void moveObject(Object* object, const sf::Vector2f& pos);
+  void removeObject(Object* object);
+  void watchObject(const ObjectHandle& object, Object* watcher);
+  void unwatchObject(const ObjectHandle& object, Object* watcher);
+  void spawnBullet(const sf::Vector2f& pos, float direction, float speed);
+  void mineAsteroid(const ObjectHandle& asteroid, int32_t amount);
+  void placeRailMissiles(Turret* turret);
+  void launchMissile(Turret* turret, const ObjectHandle& target);
+  void setProjectileVelocity(Projectile* projectile,
+                             const sf::Vector2f& velocity);
+  void setProjectileCollisionTypes(Projectile* projectile, uint32_t typeMask);
+  void adjustMinerals(int32_t amount);
+
+  // Run the given function when the buffer is applied.  Used for the rare
+  // changes that don't have a command of their own.  Functions with large
+  // captures allocate, so anything done every tick should get a command.
+  void defer(std::function<void()> function);
+
+  // Make all the recorded changes to the universe in the order they were
+  // recorded and empty the buffer.
+  void apply(Universe* universe);
+
+private:
+  enum class CommandType {
+    Move,
+    Remove,
+    Watch,
+    Unwatch,
+    Spawn,
+    Mine,
+    PlaceRail,
+    Launch,
+    SetVelocity,
+    SetCollisionTypes,
+    Deferred,
+  };
+
+  struct Command {
+    CommandType type;
+
+    // The object the command is for.  For watch commands this is the watcher,
+    // for the rail commands it is the turret and for the velocity and
+    // collision commands it is the projectile.
+    Object* object{nullptr};
+
+    // The object being watched, mined or launched at.
+    ObjectHandle handle;
+
+    // The new position for move commands, where spawned bullets start and the
+    // new velocity of a projectile.
+    sf::Vector2f pos;
+
+    // The direction and speed of spawned bullets.
+    float direction{0.f};
+    float speed{0.f};
+
+    // The amount to mine.
+    int32_t amount{0};
+
+    // The types of objects a projectile runs into.
+    uint32_t typeMask{0};
+
+    // The index into m_deferred for deferred commands.
+    size_t deferredIndex{0};
+  };
+
+  // Add a command of the given type to the end of the buffer and return it.
+  Command& record(CommandType type);
+
+  // The commands in the order they were recorded.
+  std::vector<Command> m_commands;
+
+  // Functions for deferred commands.  Kept apart so that the other commands
+  // stay small.
+  std::vector<std::function<void()>> m_deferred;
+
+  // Minerals are only ever added up, so we only keep the total.
+  int32_t m_minerals{0};
+
+  DISALLOW_COPY_AND_ASSIGN(CommandBuffer);
+};
+
+#endif  // UNIVERSE_COMMAND_BUFFER_H_
@@ -0,0 +1,173 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#include "universe/command_log.h"
+
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include <nucleus/logging.h>
+
+namespace {
+
+// The first line of every log file.
+const char* kHeader = "SpaceGameCommandLog";
+
+// The version of the format we write.  Bump this when the format changes.
+const int kVersion = 1;
+
+// The names object types are stored as.  Only objects that can be placed are
+// in here.
+struct ObjectTypeName {
+  ObjectType objectType;
+  const char* name;
+};
+
+const ObjectTypeName kObjectTypeNames[] = {
+    {ObjectType::CommandCenter, "CommandCenter"},
+    {ObjectType::PowerRelay, "PowerRelay"},
+    {ObjectType::Miner, "Miner"},
+    {ObjectType::Turret, "Turret"},
+    {ObjectType::EnemyShip, "EnemyShip"},
+};
+
+const char* nameForObjectType(ObjectType objectType) {
+  for (const auto& entry : kObjectTypeNames) {
+    if (entry.objectType == objectType) {
+      return entry.name;
+    }
+  }
+  return nullptr;
+}
+
+bool objectTypeForName(const std::string& name, ObjectType* objectTypeOut) {
+  for (const auto& entry : kObjectTypeNames) {
+    if (name == entry.name) {
+      *objectTypeOut = entry.objectType;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+CommandLog::CommandLog() {
+}
+
+CommandLog::~CommandLog() {
+}
+
+void CommandLog::record(const PlacementCommand& command) {
+  DCHECK(m_commands.empty() || m_commands.back().tick <= command.tick);
+
+  m_commands.push_back(command);
+}
+
+void CommandLog::clear() {
+  m_commands.clear();
+}
+
+bool CommandLog::saveToFile(const std::string& path) const {
+  std::ofstream file{path};
+  if (!file) {
+    LOG(Error) << "Could not open command log for writing: " << path;
+    return false;
+  }
+
+  // Write enough digits that the positions read back exactly.
+  file.precision(std::numeric_limits<float>::max_digits10);
+
+  file << kHeader << ' ' << kVersion << '\n';
+  file << "seed " << m_seed << '\n';
+  file << "adjustment " << m_adjustment << '\n';
+
+  for (const auto& command : m_commands) {
+    const char* name = nameForObjectType(command.objectType);
+    if (!name) {
+      LOG(Error) << "Can't store placement of object type "
+                 << static_cast<int>(command.objectType);
+      continue;
+    }
+
+    file << "place " << command.tick << ' ' << name << ' ' << command.pos.x
+         << ' ' << command.pos.y << '\n';
+  }
+
+  return static_cast<bool>(file);
+}
+
+bool CommandLog::loadFromFile(const std::string& path) {
+  std::ifstream file{path};
+  if (!file) {
+    LOG(Error) << "Could not open command log: " << path;
+    return false;
+  }
+
+  std::string line;
+  std::getline(file, line);
+
+  std::istringstream headerStream{line};
+  std::string header;
+  int version = 0;
+  if (!(headerStream >> header >> version) || header != kHeader ||
+      version != kVersion) {
+    LOG(Error) << "Not a command log we can read: " << path;
+    return false;
+  }
+
+  uint64_t seed = 0;
+  float adjustment = 1.f;
+  std::vector<PlacementCommand> commands;
+
+  size_t lineNumber = 1;
+  while (std::getline(file, line)) {
+    ++lineNumber;
+    if (line.empty()) {
+      continue;
+    }
+
+    std::istringstream ss{line};
+    std::string keyword;
+    ss >> keyword;
+
+    bool valid = false;
+    if (keyword == "seed") {
+      valid = static_cast<bool>(ss >> seed);
+    } else if (keyword == "adjustment") {
+      valid = static_cast<bool>(ss >> adjustment);
+    } else if (keyword == "place") {
+      PlacementCommand command;
+      std::string name;
+      valid = (ss >> command.tick >> name >> command.pos.x >> command.pos.y) &&
+              objectTypeForName(name, &command.objectType) &&
+              (commands.empty() || commands.back().tick <= command.tick);
+      if (valid) {
+        commands.push_back(command);
+      }
+    }
+
+    if (!valid) {
+      LOG(Error) << "Invalid command on line " << lineNumber << " of " << path;
+      return false;
+    }
+  }
+
+  m_seed = seed;
+  m_adjustment = adjustment;
+  m_commands.swap(commands);
+
+  return true;
+}
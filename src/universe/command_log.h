@@ -0,0 +1,99 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#ifndef UNIVERSE_COMMAND_LOG_H_
+#define UNIVERSE_COMMAND_LOG_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <nucleus/macros.h>
+#include <SFML/System/Vector2.hpp>
+
+#include "universe/objects/object.h"
+
+// An object placed into the universe from outside of the simulation, by the
+// player or a tool.
+struct PlacementCommand {
+  // The number of ticks the universe had run when the object was placed.
+  uint64_t tick;
+
+  // The type of object that was placed.
+  ObjectType objectType;
+
+  // Where the object was placed.
+  sf::Vector2f pos;
+};
+
+// Everything needed to run a game again: the seed the universe was created
+// with, the adjustment it was ticked with and every object that was placed.
+// Because the simulation is deterministic, feeding the commands into a new
+// universe at the same ticks ends up in exactly the same state.
+//
+// Logs are stored as text:
+//
+//   SpaceGameCommandLog 1
+//   seed 1234
+//   adjustment 1
+//   place 0 PowerRelay 1000 0
+//   place 120 EnemyShip -4000 12.5
+//   ...
+class CommandLog {
+public:
+  CommandLog();
+  ~CommandLog();
+
+  // Get/set the seed the universe was created with.
+  uint64_t getSeed() const { return m_seed; }
+  void setSeed(uint64_t seed) { m_seed = seed; }
+
+  // Get/set the adjustment the universe is ticked with.
+  float getAdjustment() const { return m_adjustment; }
+  void setAdjustment(float adjustment) { m_adjustment = adjustment; }
+
+  // Return all the commands in the order they were recorded.
+  const std::vector<PlacementCommand>& getCommands() const {
+    return m_commands;
+  }
+
+  // Add a command to the end of the log.  Commands must be recorded in tick
+  // order.
+  void record(const PlacementCommand& command);
+
+  // Remove all the commands.
+  void clear();
+
+  // Write the log to the given file.  Returns false if the file could not be
+  // written.
+  bool saveToFile(const std::string& path) const;
+
+  // Replace the log with the one in the given file.  Returns false if the file
+  // could not be read or is not a valid log.
+  bool loadFromFile(const std::string& path);
+
+private:
+  // The seed the universe was created with.
+  uint64_t m_seed{0};
+
+  // The adjustment the universe is ticked with.
+  float m_adjustment{1.f};
+
+  // The recorded commands in tick order.
+  std::vector<PlacementCommand> m_commands;
+
+  DISALLOW_COPY_AND_ASSIGN(CommandLog);
+};
+
+#endif  // UNIVERSE_COMMAND_LOG_H_
@@ -39,37 +39,42 @@ void Hud::updateUniverseMousePos(const sf::Vector2f& universeMousePos) {
   m_universeMousePos = universeMousePos;
 
   // Find the hover object.
-  m_hoverObject = m_universe->findObjectAt(universeMousePos);
+  setHoverObject(m_universe->findObjectAt(universeMousePos));
 }
 
 void Hud::setHoverObject(Object* object) {
-  m_hoverObject = object;
+  m_hoverObject = object ? object->getHandle() : ObjectHandle{};
 }
 
 void Hud::setSelectedObject(Object* object) {
-  m_selectedObject = object;
+  m_selectedObject = object ? object->getHandle() : ObjectHandle{};
 }
 
 void Hud::tick(float adjustment) {
   // Update the hover shape.
-  if (m_hoverObject) {
-    adjustShapeOverObject(m_hoverObject, &m_hoverShape, 4);
+  Object* hoverObject = m_universe->resolve(m_hoverObject);
+  if (hoverObject) {
+    adjustShapeOverObject(hoverObject, &m_hoverShape, 4);
   }
 
   // Update the selected shape.
-  if (m_selectedObject) {
-    adjustShapeOverObject(m_selectedObject, &m_selectedShape, 4);
+  Object* selectedObject = m_universe->resolve(m_selectedObject);
+  if (selectedObject) {
+    adjustShapeOverObject(selectedObject, &m_selectedShape, 4);
   }
 }
 
 void Hud::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+  Object* hoverObject = m_universe->resolve(m_hoverObject);
+  Object* selectedObject = m_universe->resolve(m_selectedObject);
+
   // Draw the shape over the hover object if the hover object is not the same
   // object as the selected object.
-  if (m_hoverObject && m_hoverObject != m_selectedObject) {
+  if (hoverObject && hoverObject != selectedObject) {
     target.draw(m_hoverShape, states);
   }
 
-  if (m_selectedObject) {
+  if (selectedObject) {
     target.draw(m_selectedShape, states);
   }
 }
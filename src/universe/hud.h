@@ -19,6 +19,7 @@
 
 #include <SFML/Graphics/RectangleShape.hpp>
 
+#include "universe/object_handle.h"
 #include "utils/component.h"
 
 class Object;
@@ -57,16 +58,16 @@ private:
   // The current position of the mouse inside the universe.
   sf::Vector2f m_universeMousePos;
 
-  // The object currently under the mouse pointer at any given time.  null if
-  // there are no objects under the mouse.
-  Object* m_hoverObject{nullptr};
+  // The object currently under the mouse pointer at any given time.  Doesn't
+  // resolve if there are no objects under the mouse.
+  ObjectHandle m_hoverObject;
 
   // The shape used to render over the hover object.
   sf::RectangleShape m_hoverShape;
 
-  // The object that is currently selected.  null if no object is currently
-  // selected.
-  Object* m_selectedObject{nullptr};
+  // The object that is currently selected.  Doesn't resolve if no object is
+  // currently selected.
+  ObjectHandle m_selectedObject;
 
   // The shape used to render over the selected object.
   sf::RectangleShape m_selectedShape;
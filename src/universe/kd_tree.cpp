@@ -0,0 +1,112 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#include "universe/kd_tree.h"
+
+#include <algorithm>
+
+#include "universe/objects/object.h"
+
+namespace {
+
+// Return the coordinate of pos along the axis that splits nodes at depth.
+float axisValue(const sf::Vector2f& pos, size_t depth) {
+  return (depth % 2) ? pos.y : pos.x;
+}
+
+}  // namespace
+
+KdTree::KdTree() {
+}
+
+KdTree::~KdTree() {
+}
+
+void KdTree::build(const std::vector<Object*>& objects) {
+  m_nodes.clear();
+  m_nodes.reserve(objects.size());
+  for (size_t i = 0; i < objects.size(); ++i) {
+    m_nodes.push_back(Node{objects[i]->getPos(), objects[i],
+                           static_cast<uint32_t>(i)});
+  }
+
+  buildRange(0, m_nodes.size(), 0);
+
+  m_isStale = false;
+}
+
+Object* KdTree::findClosestObject(const sf::Vector2f& pos,
+                                 float maxRange) const {
+  // Squaring the default range of float max overflows to infinity, which
+  // still works as "no limit".
+  Closest closest{nullptr, maxRange * maxRange};
+  searchRange(0, m_nodes.size(), 0, pos, &closest);
+
+  return closest.node ? closest.node->object : nullptr;
+}
+
+void KdTree::buildRange(size_t begin, size_t end, size_t depth) {
+  if (end - begin <= 1) {
+    return;
+  }
+
+  // Nodes on the splitting line are ordered by their list order, so the tree
+  // is the same no matter how nth_element shuffles them.
+  const size_t middle = begin + (end - begin) / 2;
+  std::nth_element(
+      std::begin(m_nodes) + begin, std::begin(m_nodes) + middle,
+      std::begin(m_nodes) + end, [depth](const Node& left, const Node& right) {
+        const float leftValue = axisValue(left.pos, depth);
+        const float rightValue = axisValue(right.pos, depth);
+        return leftValue < rightValue ||
+               (leftValue == rightValue && left.order < right.order);
+      });
+
+  buildRange(begin, middle, depth + 1);
+  buildRange(middle + 1, end, depth + 1);
+}
+
+void KdTree::searchRange(size_t begin, size_t end, size_t depth,
+                         const sf::Vector2f& pos, Closest* closest) const {
+  if (begin >= end) {
+    return;
+  }
+
+  const size_t middle = begin + (end - begin) / 2;
+  const Node& node = m_nodes[middle];
+
+  const sf::Vector2f delta = node.pos - pos;
+  const float distanceSquared = delta.x * delta.x + delta.y * delta.y;
+  if (distanceSquared < closest->distanceSquared ||
+      (distanceSquared == closest->distanceSquared &&
+       (!closest->node || node.order < closest->node->order))) {
+    closest->node = &node;
+    closest->distanceSquared = distanceSquared;
+  }
+
+  // Search the side of the splitting line that pos is on first, so that the
+  // other side can be skipped when it is further away than what we found.
+  const float split = axisValue(pos, depth) - axisValue(node.pos, depth);
+  if (split < 0.f) {
+    searchRange(begin, middle, depth + 1, pos, closest);
+    if (split * split <= closest->distanceSquared) {
+      searchRange(middle + 1, end, depth + 1, pos, closest);
+    }
+  } else {
+    searchRange(middle + 1, end, depth + 1, pos, closest);
+    if (split * split <= closest->distanceSquared) {
+      searchRange(begin, middle, depth + 1, pos, closest);
+    }
+  }
+}
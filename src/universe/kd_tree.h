@@ -0,0 +1,86 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#ifndef UNIVERSE_KD_TREE_H_
+#define UNIVERSE_KD_TREE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <nucleus/macros.h>
+#include <SFML/System/Vector2.hpp>
+
+class Object;
+
+// A 2D tree over the positions of a set of objects that don't move, for
+// closest object queries in O(log n).  The tree is built once from a list of
+// objects and has to be rebuilt when the list changes, so it is meant for
+// objects like structures that are placed and destroyed far less often than
+// they are searched for.
+class KdTree {
+public:
+  KdTree();
+  ~KdTree();
+
+  // Return true if the objects changed since the tree was last built.
+  bool isStale() const { return m_isStale; }
+
+  // Mark the tree as out of date with its objects.
+  void markStale() { m_isStale = true; }
+
+  // Build the tree from the given objects at their current positions.  The
+  // tree doesn't depend on anything but the order of the objects, so the
+  // same list always results in the same tree.
+  void build(const std::vector<Object*>& objects);
+
+  // Find the closest object to pos that is within maxRange.  Objects at the
+  // same distance are decided by their order in the list the tree was built
+  // from.
+  Object* findClosestObject(const sf::Vector2f& pos, float maxRange) const;
+
+private:
+  struct Node {
+    sf::Vector2f pos;
+    Object* object;
+
+    // The order of the object in the list the tree was built from.
+    uint32_t order;
+  };
+
+  // The closest object found so far during a search.
+  struct Closest {
+    const Node* node;
+    float distanceSquared;
+  };
+
+  // Arrange the nodes in [begin, end) so that the median along the axis for
+  // depth is in the middle, with the nodes before it on one side and the ones
+  // after it on the other, and recurse into both halves.
+  void buildRange(size_t begin, size_t end, size_t depth);
+
+  // Search the nodes in [begin, end) for one closer to pos than closest.
+  void searchRange(size_t begin, size_t end, size_t depth,
+                   const sf::Vector2f& pos, Closest* closest) const;
+
+  // The nodes laid out as an implicit tree: the root of every range is the
+  // node in the middle of it.
+  std::vector<Node> m_nodes;
+
+  // Whether the objects changed since the tree was built.
+  bool m_isStale{true};
+
+  DISALLOW_COPY_AND_ASSIGN(KdTree);
+};
+
+#endif  // UNIVERSE_KD_TREE_H_
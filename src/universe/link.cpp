@@ -14,10 +14,9 @@
 
 #include "universe/link.h"
 
-#include <SFML/Graphics/RenderTarget.hpp>
-
 #include "universe/objects/object.h"
-#include "utils/math.h"
+
+DEFINE_POOLED(Link, 128);
 
 Link::Link(Universe* universe, Object* source, Object* destination)
   : m_universe(universe), m_source(source), m_destination(destination) {
@@ -26,22 +25,8 @@ Link::Link(Universe* universe, Object* source, Object* destination)
 Link::~Link() {
 }
 
-void Link::tick(float adjustment) {
-  // Calculate the geometry of the shape.
-  // Get the positions of the objects.
-  sf::Vector2f sourcePos{m_source->getPos()};
-  sf::Vector2f destinationPos{m_destination->getPos()};
-
-  // Get the direction and distance.
-  float directionToDestination = directionBetween(sourcePos, destinationPos);
-  float distanceToDestination = distanceBetween(sourcePos, destinationPos);
-
-  m_shape.setSize(sf::Vector2f{distanceToDestination, 5.f});
-  m_shape.setOrigin(sf::Vector2f{0.f, -10.f});
-  m_shape.setRotation(directionToDestination);
-}
-
-void Link::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-  states.transform.translate(m_source->getPos());
-  target.draw(m_shape, states);
+const CachedLineQuad& Link::getGeometry(
+    const sf::Vector2f& sourcePos, const sf::Vector2f& destinationPos) const {
+  m_geometry.placeAlong(sourcePos, destinationPos);
+  return m_geometry;
 }
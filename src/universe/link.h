@@ -15,14 +15,20 @@
 #ifndef UNIVERSE_LINK_H_
 #define UNIVERSE_LINK_H_
 
+#include <cstddef>
+
 #include <nucleus/macros.h>
-#include <SFML/Graphics/Drawable.hpp>
-#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include "utils/memory_pool.h"
+#include "utils/vertex_builder.h"
 
 class Object;
 class Universe;
 
-class Link : public sf::Drawable {
+class Link {
+  DECLARE_POOLED(Link);
+
 public:
   Link(Universe* universe, Object* source, Object* destination);
   ~Link();
@@ -31,12 +37,14 @@ public:
   Object* getSource() const { return m_source; }
   Object* getDestination() const { return m_destination; }
 
-  void tick(float adjustment);
-
-  // Override: sf::Drawable
-  void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+  // Return the quad the link is drawn as between the given positions of its
+  // source and destination.
+  const CachedLineQuad& getGeometry(const sf::Vector2f& sourcePos,
+                                    const sf::Vector2f& destinationPos) const;
 
 private:
+  friend class PowerGrid;
+
   // The universe we belong to.
   Universe* m_universe;
 
@@ -46,8 +54,11 @@ private:
   // The destination object of the link.
   Object* m_destination;
 
-  // The shape we use to render the link.
-  sf::RectangleShape m_shape;
+  // Our index in the power grid's list of links.
+  size_t m_gridIndex{0};
+
+  // The link is drawn slightly offset from the line between the objects.
+  mutable CachedLineQuad m_geometry{10.f, 15.f};
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(Link);
 };
@@ -0,0 +1,53 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#ifndef UNIVERSE_OBJECT_HANDLE_H_
+#define UNIVERSE_OBJECT_HANDLE_H_
+
+#include <cstdint>
+#include <limits>
+
+// A weak reference to an object in the universe.  A handle is made up of the
+// slot the object lives in and the generation of that slot at the time the
+// object was added.  When the object is removed the slot's generation is
+// bumped, so Universe::resolve returns null for any handles still pointing to
+// it, even if the slot has been reused by another object.
+struct ObjectHandle {
+  static const uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+  ObjectHandle() {}
+  ObjectHandle(uint32_t index, uint32_t generation)
+    : index(index), generation(generation) {}
+
+  // Returns true if the handle was ever assigned to an object.  This does not
+  // mean that the object is still alive.
+  bool isValid() const { return index != kInvalidIndex; }
+
+  // Reset the handle so that it doesn't refer to any object.
+  void reset() { *this = ObjectHandle{}; }
+
+  bool operator==(const ObjectHandle& other) const {
+    return index == other.index && generation == other.generation;
+  }
+
+  bool operator!=(const ObjectHandle& other) const { return !(*this == other); }
+
+  // The slot in the universe that the object lives in.
+  uint32_t index{kInvalidIndex};
+
+  // The generation of the slot when the object was added.
+  uint32_t generation{0};
+};
+
+#endif  // UNIVERSE_OBJECT_HANDLE_H_
@@ -0,0 +1,230 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#include "universe/object_renderer.h"
+
+#include <nucleus/logging.h>
+#include <SFML/Graphics/RenderTarget.hpp>
+
+#include "universe/link.h"
+#include "universe/objects/asteroid.h"
+#include "universe/objects/projectiles/bullet.h"
+#include "universe/objects/projectiles/missile.h"
+#include "universe/objects/structures/command_center.h"
+#include "universe/objects/structures/miner.h"
+#include "universe/objects/structures/power_relay.h"
+#include "universe/objects/structures/turret.h"
+#include "universe/objects/units/enemy_ship.h"
+#include "universe/universe.h"
+#include "utils/vertex_builder.h"
+
+namespace {
+
+// Return a color with its alpha faded by the hit points left.
+sf::Color fadeByHitPoints(sf::Color color, const DestructibleObject& object) {
+  color.a = static_cast<sf::Uint8>(255 * object.getHitPoints() /
+                                   object.getMaxHitPoints());
+  return color;
+}
+
+// Return a transform that moves local coordinates to pos and rotates them by
+// direction.
+sf::Transform transformFor(const sf::Vector2f& pos, float direction) {
+  sf::Transform transform;
+  transform.translate(pos);
+  transform.rotate(direction);
+  return transform;
+}
+
+}  // namespace
+
+ObjectRenderer::ObjectRenderer(Universe* universe)
+  : m_universe(universe), m_shapeVertices(sf::Triangles),
+    m_textureVertices(sf::Triangles) {
+#if BUILD(DEBUG)
+  sf::Font* font = m_universe ? m_universe->getResourceManager()->getFont(
+                                    ResourceManager::Font::Default)
+                              : nullptr;
+  if (font) {
+    m_labelText.setFont(*font);
+    m_labelText.setColor(sf::Color{255, 255, 255, 255});
+    m_labelText.setCharacterSize(20);
+  }
+#endif  // BUILD(DEBUG)
+}
+
+ObjectRenderer::~ObjectRenderer() {
+}
+
+void ObjectRenderer::add(const Object& object) {
+  const sf::Vector2f pos = object.getInterpolatedPos(m_interpolation);
+
+  switch (object.getType()) {
+    case ObjectType::Asteroid: {
+      const Asteroid& asteroid = static_cast<const Asteroid&>(object);
+      const sf::Vector2f& size = asteroid.getSize();
+      appendTexturedRectangle(
+          transformFor(pos, asteroid.getRotation()),
+          sf::FloatRect{-size.x / 2.f, -size.y / 2.f, size.x, size.y},
+          m_universe->getResourceManager()->getAtlasRect(
+              asteroid.getTexture()),
+          &m_textureVertices);
+      break;
+    }
+
+    case ObjectType::CommandCenter: {
+      const CommandCenter& commandCenter =
+          static_cast<const CommandCenter&>(object);
+      const sf::Vector2f& size = commandCenter.getSize();
+      appendTexturedRectangle(
+          transformFor(pos, 0.f),
+          sf::FloatRect{-size.x / 2.f, -size.y / 2.f, size.x, size.y},
+          m_universe->getResourceManager()->getAtlasRect(
+              ResourceManager::Texture::CommandCenter),
+          &m_textureVertices);
+      break;
+    }
+
+    case ObjectType::PowerRelay: {
+      const PowerRelay& powerRelay = static_cast<const PowerRelay&>(object);
+      appendCircle(pos, PowerRelay::kRadius,
+                   fadeByHitPoints(sf::Color{255, 255, 0, 255}, powerRelay),
+                   &m_shapeVertices);
+      break;
+    }
+
+    case ObjectType::Miner: {
+      // The lasers are added separately with addLasers.
+      appendCircle(pos, Miner::kRadius, sf::Color{0, 255, 255, 255},
+                   &m_shapeVertices);
+      break;
+    }
+
+    case ObjectType::Turret: {
+      const Turret& turret = static_cast<const Turret&>(object);
+      appendCircle(pos, Turret::kRadius,
+                   fadeByHitPoints(sf::Color{0, 255, 0, 255}, turret),
+                   &m_shapeVertices);
+      appendRectangle(transformFor(pos, turret.getDirection()),
+                      sf::FloatRect{-10.f, -20.f, 20.f, 40.f},
+                      sf::Color{0, 127, 0, 255}, &m_shapeVertices);
+      break;
+    }
+
+    case ObjectType::EnemyShip: {
+      const EnemyShip& enemyShip = static_cast<const EnemyShip&>(object);
+      appendTriangle(transformFor(pos, enemyShip.getDirection()),
+                     sf::Vector2f{0.f, -25.f}, sf::Vector2f{75.f, 0.f},
+                     sf::Vector2f{0.f, 25.f}, sf::Color{255, 0, 0, 255},
+                     &m_shapeVertices);
+#if BUILD(DEBUG)
+      m_labels.emplace_back(pos, enemyShip.getDebugInfo());
+#endif  // BUILD(DEBUG)
+      break;
+    }
+
+    case ObjectType::Bullet: {
+      const Bullet& bullet = static_cast<const Bullet&>(object);
+      appendRectangle(transformFor(pos, bullet.getDirection()),
+                      sf::FloatRect{15.f, -2.5f, 25.f, 5.f},
+                      sf::Color{255, 0, 0, 255}, &m_shapeVertices);
+      break;
+    }
+
+    case ObjectType::Missile: {
+      const Missile& missile = static_cast<const Missile&>(object);
+      appendTriangle(transformFor(pos, missile.getDirection()),
+                     sf::Vector2f{0.f, 0.f}, sf::Vector2f{-10.f, 5.f},
+                     sf::Vector2f{-10.f, -5.f}, sf::Color{255, 0, 0, 255},
+                     &m_shapeVertices);
+      break;
+    }
+
+    default:
+      LOG(Error) << "No geometry for object type "
+                 << static_cast<int>(object.getType());
+      break;
+  }
+}
+
+const CachedLineQuad& ObjectRenderer::getLinkGeometry(
+    const Link& link) const {
+  return link.getGeometry(
+      link.getSource()->getInterpolatedPos(m_interpolation),
+      link.getDestination()->getInterpolatedPos(m_interpolation));
+}
+
+size_t ObjectRenderer::addLasers(const Miner& miner,
+                                 const sf::FloatRect& viewRect) {
+  const sf::Vector2f pos = miner.getInterpolatedPos(m_interpolation);
+
+  size_t addedCount = 0;
+  for (const auto& laser : miner.getLasers()) {
+    Object* asteroid = m_universe->resolve(laser.asteroid);
+    if (!asteroid) {
+      continue;
+    }
+
+    const CachedLineQuad& beam =
+        laser.getBeam(pos, asteroid->getInterpolatedPos(m_interpolation));
+    if (!beam.getBounds().intersects(viewRect)) {
+      continue;
+    }
+
+    appendQuad(beam.getCorners(), sf::Color{255, 255, 255, 255},
+               &m_shapeVertices);
+    ++addedCount;
+  }
+
+  return addedCount;
+}
+
+void ObjectRenderer::addLink(const Link& link) {
+  appendQuad(getLinkGeometry(link).getCorners(), sf::Color{255, 255, 255, 255},
+             &m_shapeVertices);
+}
+
+size_t ObjectRenderer::flush(sf::RenderTarget& target,
+                             sf::RenderStates states) {
+  size_t drawCalls = 0;
+
+  if (m_textureVertices.getVertexCount()) {
+    sf::RenderStates textureStates{states};
+    textureStates.texture = m_universe->getResourceManager()->getAtlasTexture();
+    target.draw(m_textureVertices, textureStates);
+    m_textureVertices.clear();
+    ++drawCalls;
+  }
+
+  if (m_shapeVertices.getVertexCount()) {
+    target.draw(m_shapeVertices, states);
+    m_shapeVertices.clear();
+    ++drawCalls;
+  }
+
+#if BUILD(DEBUG)
+  for (const auto& label : m_labels) {
+    m_labelText.setString(label.second);
+    const sf::FloatRect bounds{m_labelText.getLocalBounds()};
+    m_labelText.setOrigin(
+        sf::Vector2f{bounds.width / 2.f, bounds.height / 2.f});
+    m_labelText.setPosition(label.first);
+    target.draw(m_labelText, states);
+    ++drawCalls;
+  }
+  m_labels.clear();
+#endif  // BUILD(DEBUG)
+
+  return drawCalls;
+}
@@ -0,0 +1,96 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#ifndef UNIVERSE_OBJECT_RENDERER_H_
+#define UNIVERSE_OBJECT_RENDERER_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nucleus/config.h>
+#include <nucleus/macros.h>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+#include "universe/link.h"
+
+namespace sf {
+class RenderTarget;
+}  // namespace sf
+
+class Miner;
+class Object;
+class Universe;
+
+// Builds the geometry for objects from their simulation state.  Objects don't
+// know how they look, so the view adds the objects that are visible and the
+// renderer draws them all with as few draw calls as possible.
+class ObjectRenderer {
+public:
+  explicit ObjectRenderer(Universe* universe);
+  ~ObjectRenderer();
+
+  // Set how far the simulation is between its last tick and the next one.
+  // Objects are drawn between their previous and current positions.
+  void setInterpolation(float interpolation) {
+    m_interpolation = interpolation;
+  }
+
+  // Add the geometry for the given object.
+  void add(const Object& object);
+
+  // Add the laser beams of the given miner that are inside viewRect.  Beams
+  // reach well past the miner, so they are culled on their own rather than
+  // with the miner.  Returns the number of beams that were added.
+  size_t addLasers(const Miner& miner, const sf::FloatRect& viewRect);
+
+  // Return the geometry of the link at the positions its objects are drawn
+  // at.
+  const CachedLineQuad& getLinkGeometry(const Link& link) const;
+
+  // Add the geometry for the given link.
+  void addLink(const Link& link);
+
+  // Draw everything that was added since the last flush and start over.
+  // Returns the number of draw calls that were made.
+  size_t flush(sf::RenderTarget& target, sf::RenderStates states);
+
+private:
+  // The universe the objects live in.
+  Universe* m_universe;
+
+  // How far we are between the previous and current tick.
+  float m_interpolation{1.f};
+
+  // Vertices for everything drawn with plain colors.
+  sf::VertexArray m_shapeVertices;
+
+  // Vertices for everything drawn from the texture atlas.
+  sf::VertexArray m_textureVertices;
+
+#if BUILD(DEBUG)
+  // Text drawn over objects with the position it is drawn at.
+  std::vector<std::pair<sf::Vector2f, std::string>> m_labels;
+
+  // The text we use to draw the labels.
+  sf::Text m_labelText;
+#endif  // BUILD(DEBUG)
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(ObjectRenderer);
+};
+
+#endif  // UNIVERSE_OBJECT_RENDERER_H_
@@ -14,32 +14,28 @@
 
 #include "universe/objects/asteroid.h"
 
-#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Transform.hpp>
 
 #include "universe/universe.h"
+#include "utils/math.h"
 
 DEFINE_OBJECT(Asteroid, "Power Generator");
+DEFINE_POOLED(Asteroid, 128);
 
 Asteroid::Asteroid(Universe* universe, const sf::Vector2f& pos,
                    int32_t initialMinerals)
   : Object(universe, ObjectType::Asteroid, pos), m_minerals(initialMinerals) {
   // Set the rotation speed.
-  m_rotationSpeed = (static_cast<float>(std::rand() % 100) - 50.f) / 100.f;
+  m_rotationSpeed = universe->getRandom()->nextFloat(-0.5f, 0.5f);
 
-  ResourceManager::Texture texture = ResourceManager::Texture::Asteroid3;
+  m_texture = ResourceManager::Texture::Asteroid3;
   if (m_minerals < 700) {
-    texture = ResourceManager::Texture::Asteroid2;
+    m_texture = ResourceManager::Texture::Asteroid2;
   } else if (m_minerals < 400) {
-    texture = ResourceManager::Texture::Asteroid1;
+    m_texture = ResourceManager::Texture::Asteroid1;
   }
 
-  m_texture = universe->getResourceManager()->getTexture(texture);
-
-  if (m_texture) {
-    m_shape.setTexture(*m_texture);
-    sf::FloatRect bounds = m_shape.getLocalBounds();
-    m_shape.setOrigin(sf::Vector2f{bounds.width / 2.f, bounds.height / 2.f});
-  }
+  updateSize();
 }
 
 Asteroid::~Asteroid() {
@@ -65,18 +61,66 @@ int32_t Asteroid::mine(int32_t amount) {
 }
 
 sf::FloatRect Asteroid::getBounds() const {
-  sf::FloatRect bounds = m_shape.getGlobalBounds();
-  bounds.left += m_pos.x;
-  bounds.top += m_pos.y;
-  return bounds;
+  if (m_hasBounds && m_pos == m_boundsPos && m_rotation == m_boundsRotation) {
+    return m_bounds;
+  }
+
+  sf::Transform transform;
+  transform.translate(m_pos);
+  transform.rotate(m_rotation);
+  m_bounds = transform.transformRect(sf::FloatRect{
+      -m_size.x / 2.f, -m_size.y / 2.f, m_size.x, m_size.y});
+
+  m_boundsPos = m_pos;
+  m_boundsRotation = m_rotation;
+  m_hasBounds = true;
+
+  return m_bounds;
 }
 
 void Asteroid::tick(float adjustment) {
-  m_shape.rotate(m_rotationSpeed);
+  m_rotation = wrap(m_rotation + m_rotationSpeed * adjustment, 0.f, 360.f);
+}
+
+void Asteroid::hashState(StateHash* hash) const {
+  Object::hashState(hash);
+  hash->add(m_minerals);
+  hash->add(m_rotationSpeed);
+  hash->add(m_rotation);
+  hash->add(m_texture);
+}
+
+void Asteroid::saveState(BinaryWriter* writer) const {
+  Object::saveState(writer);
+  writer->write(m_minerals);
+  writer->write(m_rotationSpeed);
+  writer->write(m_rotation);
+  writer->write(m_texture);
+}
+
+void Asteroid::loadState(BinaryReader* reader) {
+  Object::loadState(reader);
+  reader->read(&m_minerals);
+  reader->read(&m_rotationSpeed);
+  reader->read(&m_rotation);
+
+  // The texture is picked from the minerals we started with, so it has to be
+  // stored as well.
+  ResourceManager::Texture texture;
+  if (reader->read(&texture) &&
+      texture >= ResourceManager::Texture::Asteroid1 &&
+      texture <= ResourceManager::Texture::Asteroid3) {
+    m_texture = texture;
+    updateSize();
+  } else {
+    reader->fail();
+  }
 }
 
-void Asteroid::draw(sf::RenderTarget& target,
-                          sf::RenderStates states) const {
-  states.transform.translate(m_pos);
-  target.draw(m_shape, states);
+void Asteroid::updateSize() {
+  const sf::IntRect textureRect =
+      m_universe->getResourceManager()->getAtlasRect(m_texture);
+  m_size = sf::Vector2f{static_cast<float>(textureRect.width),
+                        static_cast<float>(textureRect.height)};
+  m_hasBounds = false;
 }
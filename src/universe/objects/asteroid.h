@@ -15,14 +15,13 @@
 #ifndef UNIVERSE_OBJECTS_ASTEROID_H_
 #define UNIVERSE_OBJECTS_ASTEROID_H_
 
-#include <vector>
-
-#include <SFML/Graphics/Sprite.hpp>
-
+#include "game/resource_manager.h"
 #include "universe/objects/object.h"
+#include "utils/memory_pool.h"
 
 class Asteroid : public Object {
   DECLARE_OBJECT(Asteroid);
+  DECLARE_POOLED(Asteroid);
 
 public:
   Asteroid(Universe* universe, const sf::Vector2f& pos,
@@ -35,23 +34,44 @@ public:
   // Mine the asteroid.
   int32_t mine(int32_t amount);
 
+  // Return the texture the asteroid is drawn with, its size and the angle it
+  // has rotated to.
+  ResourceManager::Texture getTexture() const { return m_texture; }
+  const sf::Vector2f& getSize() const { return m_size; }
+  float getRotation() const { return m_rotation; }
+
   // Override: Object
   sf::FloatRect getBounds() const override;
   void tick(float adjustment) override;
-  void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+  void hashState(StateHash* hash) const override;
+  void saveState(BinaryWriter* writer) const override;
+  void loadState(BinaryReader* reader) override;
 
 private:
+  // Take the size of the asteroid from its texture.
+  void updateSize();
+
   // The amount of minerals we have.
   int32_t m_minerals;
 
   // The speed we are rotating.
   float m_rotationSpeed;
 
+  // The angle we have rotated to.
+  float m_rotation{0.f};
+
   // The texture we use to render the asteroid.
-  sf::Texture* m_texture;
+  ResourceManager::Texture m_texture;
+
+  // The size of the asteroid, taken from its texture.
+  sf::Vector2f m_size;
 
-  // The shape we use to render the power generator.
-  sf::Sprite m_shape;
+  // The last bounds we calculated and the position and rotation they were
+  // calculated for.  Bounds are asked for far more often than we move.
+  mutable sf::FloatRect m_bounds;
+  mutable sf::Vector2f m_boundsPos;
+  mutable float m_boundsRotation{0.f};
+  mutable bool m_hasBounds{false};
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(Asteroid);
 };
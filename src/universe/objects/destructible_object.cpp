@@ -20,12 +20,32 @@
 DestructibleObject::DestructibleObject(Universe* universe, ObjectType type,
                                        const sf::Vector2f& pos,
                                        int32_t hitPoints)
-  : Object(universe, type, pos), m_hitPoints(hitPoints) {
+  : Object(universe, type, pos),
+    m_hitPoints(hitPoints),
+    m_maxHitPoints(hitPoints) {
 }
 
 DestructibleObject::~DestructibleObject() {
 }
 
+void DestructibleObject::hashState(StateHash* hash) const {
+  Object::hashState(hash);
+  hash->add(m_hitPoints);
+  hash->add(m_maxHitPoints);
+}
+
+void DestructibleObject::saveState(BinaryWriter* writer) const {
+  Object::saveState(writer);
+  writer->write(m_hitPoints);
+  writer->write(m_maxHitPoints);
+}
+
+void DestructibleObject::loadState(BinaryReader* reader) {
+  Object::loadState(reader);
+  reader->read(&m_hitPoints);
+  reader->read(&m_maxHitPoints);
+}
+
 void DestructibleObject::shot(Projectile* projectile) {
   // We have been shot so remove some hitpoints.
   m_hitPoints -= projectile->getDamageAmount();
@@ -23,13 +23,23 @@ public:
                      const sf::Vector2f& pos, int32_t hitPoints);
   ~DestructibleObject() override;
 
+  // Return our current and starting hitpoints.
+  int32_t getHitPoints() const { return m_hitPoints; }
+  int32_t getMaxHitPoints() const { return m_maxHitPoints; }
+
   // Override: Object
   void shot(Projectile* projectile) override;
+  void hashState(StateHash* hash) const override;
+  void saveState(BinaryWriter* writer) const override;
+  void loadState(BinaryReader* reader) override;
 
 protected:
   // Our hitpoints.
   int32_t m_hitPoints;
 
+  // The hitpoints we started with.
+  int32_t m_maxHitPoints;
+
 private:
   DISALLOW_IMPLICIT_CONSTRUCTORS(DestructibleObject);
 };
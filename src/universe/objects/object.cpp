@@ -20,9 +20,12 @@
 
 DEFINE_OBJECT(Object, "Object");
 
-std::set<ObjectType> Object::objectTypesForStructures() {
-  return std::set<ObjectType>{ObjectType::CommandCenter, ObjectType::PowerRelay,
-                              ObjectType::Miner, ObjectType::Turret};
+// static
+const std::set<ObjectType>& Object::objectTypesForStructures() {
+  static const std::set<ObjectType> types{
+      ObjectType::CommandCenter, ObjectType::PowerRelay, ObjectType::Miner,
+      ObjectType::Turret};
+  return types;
 }
 
 // static
@@ -69,7 +72,8 @@ bool Object::isUnit(Object* object) {
 
 Object::Object(Universe* universe, ObjectType objectType,
                const sf::Vector2f& pos)
-  : m_universe(universe), m_objectType(objectType), m_pos(pos) {
+  : m_universe(universe), m_objectType(objectType), m_pos(pos),
+    m_previousPos(pos) {
 }
 
 Object::~Object() {
@@ -80,9 +84,45 @@ void Object::shot(Projectile* projectile) {
 }
 
 void Object::moveTo(const sf::Vector2f& pos) {
-  m_pos = pos;
+  setPos(pos);
+  m_previousPos = pos;
+}
+
+void Object::onAddedToUniverse() {
+  // By default we don't watch anything.
+}
+
+void Object::onWatchedObjectRemoved(const ObjectHandle& handle) {
+}
+
+sf::Vector2f Object::getInterpolatedPos(float interpolation) const {
+  return m_previousPos + (m_pos - m_previousPos) * interpolation;
+}
+
+void Object::hashState(StateHash* hash) const {
+  hash->add(m_objectType);
+  hash->add(m_handle.index);
+  hash->add(m_handle.generation);
+  hash->add(m_pos);
+  hash->add(m_previousPos);
+}
+
+void Object::saveState(BinaryWriter* writer) const {
+  writer->write(m_pos);
+  writer->write(m_previousPos);
+}
+
+void Object::loadState(BinaryReader* reader) {
+  // We are not in the spatial index yet, so we don't have to go through
+  // setPos.
+  reader->read(&m_pos);
+  reader->read(&m_previousPos);
 }
 
 float Object::calculateDistanceFrom(const sf::Vector2f& pos) const {
   return distanceBetween(m_pos, pos);
 }
+
+void Object::setPos(const sf::Vector2f& pos) {
+  m_universe->moveObject(this, pos);
+}
@@ -15,11 +15,18 @@
 #ifndef UNIVERSE_OBJECTS_OBJECT_H_
 #define UNIVERSE_OBJECTS_OBJECT_H_
 
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <set>
 
 #include <nucleus/macros.h>
-#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include "universe/object_handle.h"
+#include "utils/binary_stream.h"
+#include "utils/state_hash.h"
 
 class Projectile;
 class Universe;
@@ -51,11 +58,18 @@ enum class ObjectType {
   Missile,
 };
 
-class Object : public sf::Drawable {
+// The number of object types.  Keep this in sync with the last entry in
+// ObjectType.
+const size_t kObjectTypeCount = static_cast<size_t>(ObjectType::Missile) + 1;
+
+// The simulation state of everything that lives in the universe.  Objects
+// don't know how to draw themselves; the ObjectRenderer builds their geometry
+// from their state, and only for the ones that are visible.
+class Object {
   DECLARE_OBJECT(Object);
 
 public:
-  static std::set<ObjectType> objectTypesForStructures();
+  static const std::set<ObjectType>& objectTypesForStructures();
 
   static bool isAsteroid(Object* object);
   static bool isStructure(Object* object);
@@ -68,25 +82,60 @@ public:
   // objectType
   ObjectType getType() const { return m_objectType; }
 
+  // Return the handle the universe assigned to us.  The handle is invalid if
+  // we were never added to the universe.
+  const ObjectHandle& getHandle() const { return m_handle; }
+
   // pos
   const sf::Vector2f& getPos() const { return m_pos; }
 
+  // Return the position between where we were before the last tick (0.0) and
+  // where we are now (1.0).  Used to render smoothly between ticks.
+  sf::Vector2f getInterpolatedPos(float interpolation) const;
+
   // Calculate the distance from pos to this object.
   float calculateDistanceFrom(const sf::Vector2f& pos) const;
 
   // This is called when we are shot by the specified projectile.
   virtual void shot(Projectile* projectile);
 
-  // Move the object to the specified coordinates.
+  // Move the object to the specified coordinates.  The object jumps there
+  // rather than being interpolated from its old position.
   virtual void moveTo(const sf::Vector2f& pos);
 
+  // Called once the object was added to the universe and has a handle.
+  virtual void onAddedToUniverse();
+
+  // Called when an object we are watching (see Universe::watchObject) was
+  // removed from the universe.  The object is already deleted at this point.
+  virtual void onWatchedObjectRemoved(const ObjectHandle& handle);
+
   // Return the bounds of the object.
   virtual sf::FloatRect getBounds() const = 0;
 
   // Tick the object.
   virtual void tick(float adjustment) = 0;
 
+  // Add the simulation state of the object to the hash.  Objects that keep
+  // more state than their position add it as well.
+  virtual void hashState(StateHash* hash) const;
+
+  // Write the simulation state of the object to a snapshot.  Objects that keep
+  // more state than their position write it as well.
+  virtual void saveState(BinaryWriter* writer) const;
+
+  // Read the state written by saveState.  This is called on a newly created
+  // object before the universe puts it back in its slot, so the object must
+  // not talk to the universe here.
+  virtual void loadState(BinaryReader* reader);
+
 protected:
+  // Set the position of the object and let the universe know that we moved.
+  // Objects should always change their position through this so that spatial
+  // queries stay up to date.  While the universe is ticking, the new position
+  // only shows up once the tick is done.
+  void setPos(const sf::Vector2f& pos);
+
   // The universe we belong to.
   Universe* m_universe;
 
@@ -97,6 +146,28 @@ protected:
   sf::Vector2f m_pos;
 
 private:
+  friend class SpatialIndex;
+  friend class Universe;
+
+  // The handle the universe assigned to us when we were added.
+  ObjectHandle m_handle;
+
+  // Our position before the last tick.
+  sf::Vector2f m_previousPos;
+
+  // Our position in the universe's bucket for our type.  This lets the
+  // universe remove us without searching for us.
+  size_t m_bucketIndex{std::numeric_limits<size_t>::max()};
+
+  // Whether we are filed in the universe's spatial index.
+  bool m_isIndexed{false};
+
+  // The key of the spatial index cell we are filed under and our neighbours
+  // in that cell's list of objects.
+  uint64_t m_spatialCell{0};
+  Object* m_previousInCell{nullptr};
+  Object* m_nextInCell{nullptr};
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(Object);
 };
 
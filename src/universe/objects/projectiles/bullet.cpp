@@ -14,63 +14,74 @@
 
 #include "universe/objects/projectiles/bullet.h"
 
-#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Transform.hpp>
 
 #include "universe/universe.h"
 #include "utils/math.h"
 #include "utils/stream_operators.h"
 
+namespace {
+
+// The distance a bullet travels before it disappears.
+const float kMaxRange = 1500.f;
+
+}  // namespace
+
+DEFINE_POOLED(Bullet, 1024);
+
+// static
+const sf::FloatRect Bullet::kShape{15.f, -2.5f, 25.f, 5.f};
+
 Bullet::Bullet(Universe* universe, const sf::Vector2f& pos, float direction,
                float speed)
-  : Projectile(universe, ObjectType::Bullet, pos), m_direction(direction),
-    m_speed(speed), m_originalPos(pos) {
-  // Set up the circle shape.
-  m_shape.setFillColor(sf::Color{255, 0, 0, 255});
-  m_shape.setSize(sf::Vector2f{25.f, 5.f});
-  m_shape.setOrigin(sf::Vector2f{-15.f, 2.5f});
-  m_shape.setRotation(direction);
+  : Projectile(universe, ObjectType::Bullet, pos,
+               vectorInDirection(direction, speed), kMaxRange),
+    m_direction(direction) {
+  setCollisionTypes(
+      ProjectileSystem::typeMaskFor(Object::objectTypesForStructures()));
 }
 
 Bullet::~Bullet() {
 }
 
 sf::FloatRect Bullet::getBounds() const {
-  sf::FloatRect bounds = m_shape.getGlobalBounds();
-  bounds.left += m_pos.x;
-  bounds.top += m_pos.y;
-  return bounds;
+  if (m_hasBounds && m_pos == m_boundsPos) {
+    return m_bounds;
+  }
+
+  sf::Transform transform;
+  transform.translate(m_pos);
+  transform.rotate(m_direction);
+  m_bounds = transform.transformRect(kShape);
+
+  m_boundsPos = m_pos;
+  m_hasBounds = true;
+
+  return m_bounds;
 }
 
-void Bullet::tick(float adjustment) {
-  // Advance the bullet by it's speed in the direction it's travelling.
-  m_pos = sf::Vector2f{m_pos.x + std::cos(degToRad(m_direction)) * m_speed,
-                       m_pos.y + std::sin(degToRad(m_direction)) * m_speed};
-
-  // Show the bullet die after this update?
-  bool shouldDie = false;
-
-  // Check if we collided with a structure.
-  std::vector<Object*> possibles;
-  m_universe->findObjectsInRadius(Object::objectTypesForStructures(), m_pos,
-                                  10.f, &possibles);
-  if (!possibles.empty()) {
-    // Just collide with the first one.
-    possibles[0]->shot(this);
-    shouldDie = true;
-  }
+void Bullet::hashState(StateHash* hash) const {
+  Projectile::hashState(hash);
+  hash->add(m_direction);
+}
 
-  // If the distance from our current position to the original position is more
-  // than our range, then just die.
-  if (distanceBetween(m_pos, m_originalPos) > 1500.f) {
-    shouldDie = true;
-  }
+void Bullet::saveState(BinaryWriter* writer) const {
+  Projectile::saveState(writer);
+  writer->write(m_direction);
+}
 
-  if (shouldDie) {
-    m_universe->removeObject(this);
-  }
+void Bullet::loadState(BinaryReader* reader) {
+  Projectile::loadState(reader);
+  reader->read(&m_direction);
+  m_hasBounds = false;
+}
+
+void Bullet::onCollision(Object* object) {
+  object->shot(this);
+  m_universe->removeObject(this);
 }
 
-void Bullet::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-  states.transform.translate(m_pos);
-  target.draw(m_shape, states);
+void Bullet::tick(float adjustment) {
+  // The projectile system moves us, removes us when we are out of range and
+  // tells us when we hit a structure, so there is nothing left to do.
 }
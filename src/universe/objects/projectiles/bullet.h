@@ -16,33 +16,41 @@
 #define UNIVERSE_OBJECTS_PROJECTILES_BULLET_H_
 
 #include "universe/objects/projectiles/projectile.h"
-
-#include <SFML/Graphics/RectangleShape.hpp>
+#include "utils/memory_pool.h"
 
 class Bullet : public Projectile {
+  DECLARE_POOLED(Bullet);
+
 public:
+  // The bounds of every bullet relative to its position, before it is turned
+  // in the direction it travels.
+  static const sf::FloatRect kShape;
+
   Bullet(Universe* universe, const sf::Vector2f& pos, float direction,
          float speed);
   ~Bullet() override;
 
+  // Get the direction the bullet is travelling in.
+  float getDirection() const { return m_direction; }
+
   // Override: Projectile
   int32_t getDamageAmount() const override { return 50; }
+  void onCollision(Object* object) override;
   sf::FloatRect getBounds() const override;
   void tick(float adjustment) override;
-  void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+  void hashState(StateHash* hash) const override;
+  void saveState(BinaryWriter* writer) const override;
+  void loadState(BinaryReader* reader) override;
 
 private:
-  // The direction we are traveling in.
-  float m_direction{0.f};
-
-  // The speed we are travelling.
-  float m_speed{0.f};
-
-  // The original position we started to travel from.
-  sf::Vector2f m_originalPos;
-
-  // The shape we use to represent the bullet.
-  sf::RectangleShape m_shape;
+  // The direction we are travelling in.
+  float m_direction;
+
+  // The last bounds we calculated and the position they were calculated for.
+  // Bounds are asked for far more often than we move.
+  mutable sf::FloatRect m_bounds;
+  mutable sf::Vector2f m_boundsPos;
+  mutable bool m_hasBounds{false};
 
   DISALLOW_COPY_AND_ASSIGN(Bullet);
 };
@@ -14,7 +14,9 @@
 
 #include "universe/objects/projectiles/missile.h"
 
-#include <SFML/Graphics/RenderTarget.hpp>
+#include <limits>
+
+#include <SFML/Graphics/Transform.hpp>
 
 #include "universe/universe.h"
 #include "utils/math.h"
@@ -26,28 +28,25 @@ static const float kMaxSpeed = 10.f;
 
 }  // namespace
 
+DEFINE_POOLED(Missile, 256);
+
+// static
+const sf::FloatRect Missile::kShape{-10.f, -5.f, 10.f, 10.f};
+
 Missile::Missile(Universe* universe, sf::Vector2f& pos, float direction)
-  : Projectile(universe, ObjectType::Missile, pos), m_direction(direction) {
-  // Set up the shape.
-  m_shape.setPrimitiveType(sf::Triangles);
-  m_shape.append(sf::Vertex{sf::Vector2f{0.f, 0.f}, sf::Color{255, 0, 0, 255}});
-  m_shape.append(
-      sf::Vertex{sf::Vector2f{-10.f, 5.f}, sf::Color{255, 0, 0, 255}});
-  m_shape.append(
-      sf::Vertex{sf::Vector2f{-10.f, -5.f}, sf::Color{255, 0, 0, 255}});
-
-  m_objectRemovedSlotId = m_universe->getObjectRemovedSignal().connect(
-      nu::slot(&Missile::onObjectRemoved, this));
+  : Projectile(universe, ObjectType::Missile, pos, sf::Vector2f{},
+               std::numeric_limits<float>::max()),
+    m_direction(direction) {
 }
 
 Missile::~Missile() {
-  DCHECK(
-      m_universe->getObjectRemovedSignal().disconnect(m_objectRemovedSlotId));
 }
 
 void Missile::launchAt(Object* target) {
   // Target acquired...
-  m_target = target;
+  m_target = target->getHandle();
+  m_universe->watchObject(m_target, this);
+  setCollisionTypes(ProjectileSystem::typeMaskFor(ObjectType::EnemyShip));
 
   // ...LAUNCH!
   m_task = Task::Launching;
@@ -61,8 +60,16 @@ int32_t Missile::getDamageAmount() const {
   return 50;
 }
 
+void Missile::onCollision(Object* object) {
+  object->shot(this);
+  selfDestruct();
+}
+
 sf::FloatRect Missile::getBounds() const {
-  return m_shape.getBounds();
+  sf::Transform transform;
+  transform.translate(m_pos);
+  transform.rotate(m_direction);
+  return transform.transformRect(kShape);
 }
 
 void Missile::tick(float adjustment) {
@@ -73,71 +80,99 @@ void Missile::tick(float adjustment) {
 
   // If we have a target, get to it.
   if (m_task == Task::Tracking) {
+    // If our target is gone, there is nothing left to do.
+    Object* target = m_universe->resolve(m_target);
+    if (!target) {
+      selfDestruct();
+      return;
+    }
+
     // Calculate the direction to the target.
-    const float directionToTarget = directionBetween(m_pos, m_target->getPos());
+    const float directionToTarget = directionBetween(m_pos, target->getPos());
 
     // If we are not pointing directly towards the target, then we must turn.
+    const float maxTurn = kMaxTurnRadius * adjustment;
+    bool turned = false;
     if (m_direction != directionToTarget) {
+      turned = true;
+
       const float leftDiff =
           wrap(360.f - directionToTarget + m_direction, 0.f, 360.f);
       const float rightDiff = wrap(directionToTarget - m_direction, 0.f, 360.f);
 
       // Figure out which way to turn.
       const float turnSide =
-          (leftDiff < rightDiff) ? -kMaxTurnRadius : kMaxTurnRadius;
+          (leftDiff < rightDiff) ? -maxTurn : maxTurn;
 
       // Adjust the direction towards the target.
       m_direction = wrap(m_direction + turnSide, 0.f, 360.f);
 
-      // If the direction is within kMaxTurnRadius of the target direction, then
-      // snap it directly to the target, to avoid oscillation.
+      // If the direction is within a turn of the target direction, then snap
+      // it directly to the target, to avoid oscillation.
       if (std::abs(wrap(m_direction - directionToTarget, 0.f, 360.f)) <
-          kMaxTurnRadius) {
+          maxTurn) {
         m_direction = directionToTarget;
       }
     }
 
-    m_speed = kMaxSpeed;
-
-    // Adjust the position of the missile accordingly.
-    sf::Vector2f delta{std::cos(degToRad(m_direction)) * m_speed,
-                       std::sin(degToRad(m_direction)) * m_speed};
-    m_pos += delta;
-
-    bool shouldRemove = false;
-
-    // See if we collided with any enemy ships.
-    std::vector<Object*> enemyShips;
-    m_universe->findObjectsInRadius(std::set<ObjectType>{ObjectType::EnemyShip},
-                                    m_pos, 10.f, &enemyShips);
-    if (!enemyShips.empty()) {
-      m_target->shot(this);
-      shouldRemove = true;
+    // The projectile system moves us, we only have to update our velocity when
+    // we turned or changed speed.
+    if (turned || m_speed != kMaxSpeed) {
+      m_speed = kMaxSpeed;
+      setVelocity(vectorInDirection(m_direction, m_speed));
     }
 
-    // Increase the time passed since we were launched.
+    // Increase the time passed since we were launched.  The universe tells
+    // us when we hit an enemy ship.
     if (m_timeSinceLaunch > 250.f) {
-      shouldRemove = true;
       m_timeSinceLaunch = 0.f;
+      selfDestruct();
     } else {
       m_timeSinceLaunch += adjustment;
     }
-
-    if (shouldRemove) {
-      m_universe->removeObject(this);
-    }
   }
 }
 
-void Missile::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-  states.transform.translate(m_pos);
-  states.transform.rotate(m_direction);
-  target.draw(m_shape, states);
+void Missile::hashState(StateHash* hash) const {
+  Projectile::hashState(hash);
+  hash->add(m_task);
+  hash->add(m_direction);
+  hash->add(m_target.index);
+  hash->add(m_target.generation);
+  hash->add(m_speed);
+  hash->add(m_timeSinceLaunch);
+}
+
+void Missile::saveState(BinaryWriter* writer) const {
+  Projectile::saveState(writer);
+  writer->write(m_direction);
+  writer->write(m_task);
+  writer->write(m_target.index);
+  writer->write(m_target.generation);
+  writer->write(m_speed);
+  writer->write(m_timeSinceLaunch);
 }
 
-void Missile::onObjectRemoved(Object* object) {
+void Missile::loadState(BinaryReader* reader) {
+  Projectile::loadState(reader);
+  reader->read(&m_direction);
+  if (!reader->read(&m_task) || m_task > Task::Exploding) {
+    reader->fail();
+  }
+  reader->read(&m_target.index);
+  reader->read(&m_target.generation);
+  reader->read(&m_speed);
+  reader->read(&m_timeSinceLaunch);
+}
+
+void Missile::onWatchedObjectRemoved(const ObjectHandle& handle) {
   // If the object is our target, then we self-destruct.
-  if (object == m_target) {
-    m_universe->removeObject(this);
+  if (handle == m_target) {
+    selfDestruct();
   }
 }
+
+void Missile::selfDestruct() {
+  setCollisionTypes(0);
+  m_universe->removeObject(this);
+}
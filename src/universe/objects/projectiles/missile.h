@@ -16,13 +16,16 @@
 #define UNIVERSE_OBJECTS_PROJECTILE_MISSILE_H_
 
 #include "universe/objects/projectiles/projectile.h"
-
-#include <SFML/Graphics/VertexArray.hpp>
-
-#include "universe/observers.h"
+#include "utils/memory_pool.h"
 
 class Missile : public Projectile {
+  DECLARE_POOLED(Missile);
+
 public:
+  // The bounds of every missile relative to its position, before it is turned
+  // in the direction it faces.
+  static const sf::FloatRect kShape;
+
   Missile(Universe* universe, sf::Vector2f& pos, float direction);
   ~Missile() override;
 
@@ -32,14 +35,21 @@ public:
   // Launch the missile at the given target.
   void launchAt(Object* target);
 
+  // Get the direction the missile is currently facing.
+  float getDirection() const { return m_direction; }
+
   // Override the direction the missile is currently facing.
   void setDirection(float direction);
 
   // Override: Projectile
   int32_t getDamageAmount() const override;
+  void onCollision(Object* object) override;
   sf::FloatRect getBounds() const override;
   void tick(float adjustment) override;
-  void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+  void onWatchedObjectRemoved(const ObjectHandle& handle) override;
+  void hashState(StateHash* hash) const override;
+  void saveState(BinaryWriter* writer) const override;
+  void loadState(BinaryReader* reader) override;
 
 private:
   enum class Task {
@@ -49,8 +59,9 @@ private:
     Exploding,
   };
 
-  // Called when the universe removed an object.
-  void onObjectRemoved(Object* object);
+  // Remove ourselves from the universe without hitting anything else on the
+  // way out.
+  void selfDestruct();
 
   // The direction we are currently travelling.
   float m_direction;
@@ -59,7 +70,7 @@ private:
   Task m_task{Task::Idle};
 
   // The target we are attacking.
-  Object* m_target{nullptr};
+  ObjectHandle m_target;
 
   // The speed we are travelling at.
   float m_speed{0.f};
@@ -67,12 +78,6 @@ private:
   // The time that has passed since we were launched.
   float m_timeSinceLaunch{0.f};
 
-  // Id for the ObjectRemoved slot.
-  size_t m_objectRemovedSlotId;
-
-  // The shape we use to render the missile.
-  sf::VertexArray m_shape;
-
   DISALLOW_IMPLICIT_CONSTRUCTORS(Missile);
 };
 
@@ -16,12 +16,30 @@
 
 #include <cmath>
 
+#include "universe/universe.h"
 #include "utils/math.h"
 
 Projectile::Projectile(Universe* universe, ObjectType objectType,
-                       const sf::Vector2f& pos)
+                       const sf::Vector2f& pos, const sf::Vector2f& velocity,
+                       float maxRange)
   : Object(universe, objectType, pos) {
+  m_universe->getProjectileSystem()->add(this, pos, velocity, maxRange);
 }
 
 Projectile::~Projectile() {
+  m_universe->getProjectileSystem()->remove(this);
+}
+
+void Projectile::moveTo(const sf::Vector2f& pos) {
+  Object::moveTo(pos);
+
+  m_universe->getProjectileSystem()->setPos(this, pos);
+}
+
+void Projectile::setVelocity(const sf::Vector2f& velocity) {
+  m_universe->setProjectileVelocity(this, velocity);
+}
+
+void Projectile::setCollisionTypes(uint32_t typeMask) {
+  m_universe->setProjectileCollisionTypes(this, typeMask);
 }
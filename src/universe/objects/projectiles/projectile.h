@@ -19,13 +19,37 @@
 
 class Projectile : public Object {
 public:
+  // Projectiles are moved by the universe's projectile system.  They start
+  // out at pos with the given velocity (units per tick) and expire once they
+  // are further than maxRange from where they started.
   Projectile(Universe* universe, ObjectType objectType,
-             const sf::Vector2f& pos);
+             const sf::Vector2f& pos, const sf::Vector2f& velocity,
+             float maxRange);
   ~Projectile() override;
 
   virtual int32_t getDamageAmount() const = 0;
 
+  // Called by the universe when we ran into the object during the last tick.
+  // Only objects of the types set with setCollisionTypes are reported.
+  virtual void onCollision(Object* object) = 0;
+
+  // Override: Object
+  void moveTo(const sf::Vector2f& pos) override;
+
+protected:
+  // Change the velocity we are travelling at.
+  void setVelocity(const sf::Vector2f& velocity);
+
+  // Set the types of objects we collide with as a mask built with
+  // ProjectileSystem::typeMaskFor.  We don't collide with anything by default.
+  void setCollisionTypes(uint32_t typeMask);
+
 private:
+  friend class ProjectileSystem;
+
+  // Our index in the projectile system.
+  size_t m_systemIndex{0};
+
   DISALLOW_COPY_AND_ASSIGN(Projectile);
 };
 
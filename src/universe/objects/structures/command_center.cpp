@@ -14,42 +14,24 @@
 
 #include "universe/objects/structures/command_center.h"
 
-#include <SFML/Graphics/RenderTarget.hpp>
-
 #include "universe/universe.h"
 
 DEFINE_STRUCTURE(CommandCenter, "Command Center", 2000, 0);
+DEFINE_POOLED(CommandCenter, 4);
 
 CommandCenter::CommandCenter(Universe* universe, const sf::Vector2f& pos)
   : Structure(universe, ObjectType::CommandCenter, pos, 5000) {
-  m_texture = m_universe->getResourceManager()->getTexture(
-      ResourceManager::Texture::CommandCenter);
-
-  if (m_texture) {
-    m_texture->setSmooth(false);
-    m_shape.setTexture(*m_texture);
-    //m_shape.setScale(2.f, 2.f);
-    sf::FloatRect bounds = m_shape.getLocalBounds();
-    m_shape.setOrigin(bounds.width / 2.f, bounds.height / 2.f);
-  }
+  const sf::IntRect textureRect =
+      m_universe->getResourceManager()->getAtlasRect(
+          ResourceManager::Texture::CommandCenter);
+  m_size = sf::Vector2f{static_cast<float>(textureRect.width),
+                        static_cast<float>(textureRect.height)};
 }
 
 CommandCenter::~CommandCenter() {
 }
 
 sf::FloatRect CommandCenter::getBounds() const {
-  sf::FloatRect bounds = m_shape.getGlobalBounds();
-  bounds.left += m_pos.x;
-  bounds.top += m_pos.y;
-  return bounds;
-}
-
-void CommandCenter::tick(float adjustment) {
-  m_universe->adjustPower(1000);
-}
-
-void CommandCenter::draw(sf::RenderTarget& target,
-                         sf::RenderStates states) const {
-  states.transform.translate(m_pos);
-  target.draw(m_shape, states);
+  return sf::FloatRect{m_pos.x - m_size.x / 2.f, m_pos.y - m_size.y / 2.f,
+                       m_size.x, m_size.y};
 }
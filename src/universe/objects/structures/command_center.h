@@ -15,28 +15,29 @@
 #ifndef UNIVERSE_OBJECTS_STRUCTURES_COMMAND_CENTER_H_
 #define UNIVERSE_OBJECTS_STRUCTURES_COMMAND_CENTER_H_
 
-#include <SFML/Graphics/Sprite.hpp>
-
 #include "universe/objects/structures/structure.h"
+#include "utils/memory_pool.h"
 
 class CommandCenter : public Structure {
   DECLARE_STRUCTURE(CommandCenter);
+  DECLARE_POOLED(CommandCenter);
 
 public:
   CommandCenter(Universe* universe, const sf::Vector2f& pos);
   virtual ~CommandCenter() override;
 
+  // Return the size of the command center, taken from its texture.
+  const sf::Vector2f& getSize() const { return m_size; }
+
+  // Override: Structure
+  int32_t getPowerContribution() override { return 1000; }
+
   // Override: Object
   sf::FloatRect getBounds() const override;
-  void tick(float adjustment) override;
-  void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
 private:
-  // The texture to render the command center.
-  sf::Texture* m_texture;
-
-  // the shape we use to render the command center.
-  sf::Sprite m_shape;
+  // The size of the command center.
+  sf::Vector2f m_size;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(CommandCenter);
 };
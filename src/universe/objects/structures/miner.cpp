@@ -14,40 +14,47 @@
 
 #include "universe/objects/structures/miner.h"
 
-#include <SFML/Graphics/RenderTarget.hpp>
+#include <algorithm>
+#include <limits>
 
 #include "universe/universe.h"
-#include "universe/objects/asteroid.h"
 
 DEFINE_STRUCTURE(Miner, "Miner", -750, 1500);
+DEFINE_POOLED(Miner, 32);
 
-Miner::Miner(Universe* universe, const sf::Vector2f& pos)
-  : Structure(universe, ObjectType::Miner, pos, 1500), m_shape(75.f) {
-  m_shape.setFillColor(sf::Color{0, 255, 255, 255});
-  m_shape.setOrigin(m_shape.getGlobalBounds().width / 2.f,
-                    m_shape.getGlobalBounds().height / 2.f);
+// static
+const float Miner::kRadius = 75.f;
+
+// static
+const float Miner::kMiningRange = 500.f;
+
+// static
+const float Miner::kLaserWidth = 5.f;
 
-  recreateLasers();
+const CachedLineQuad& Miner::Laser::getBeam(
+    const sf::Vector2f& minerPos, const sf::Vector2f& asteroidPos) const {
+  beam.placeAlong(minerPos, asteroidPos);
+  return beam;
+}
 
-  m_removedObjectId = m_universe->getObjectRemovedSignal().connect(
-      nu::slot(&Miner::onObjectRemoved, this));
+Miner::Miner(Universe* universe, const sf::Vector2f& pos)
+  : Structure(universe, ObjectType::Miner, pos, 1500) {
+  updateLasers();
 }
 
 Miner::~Miner() {
-  m_universe->getObjectRemovedSignal().disconnect(m_removedObjectId);
 }
 
 void Miner::moveTo(const sf::Vector2f& pos) {
   Structure::moveTo(pos);
 
-  m_shape.setPosition(pos);
-
-  // We have move position, so recreate all our lasers.
-  recreateLasers();
+  // We have moved, so other asteroids might be in range now.
+  updateLasers();
 }
 
 sf::FloatRect Miner::getBounds() const {
-  return m_shape.getGlobalBounds();
+  return sf::FloatRect{m_pos.x - kRadius, m_pos.y - kRadius, kRadius * 2.f,
+                       kRadius * 2.f};
 }
 
 void Miner::tick(float adjustment) {
@@ -61,74 +68,97 @@ void Miner::tick(float adjustment) {
   }
 }
 
-void Miner::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-  // Draw all the lasers
+void Miner::onAddedToUniverse() {
+  // We couldn't watch our asteroids before we had a handle, so do it now.
   for (const auto& laser : m_lasers) {
-    target.draw(*laser, states);
+    m_universe->watchObject(laser.asteroid, this);
   }
-
-  // Draw the miner itself.
-  target.draw(m_shape, states);
 }
 
-Miner::Laser::Laser(Universe* universe, Miner* miner, Asteroid* asteroid)
-  : m_universe(universe), m_miner(miner), m_asteroid(asteroid) {
-  // Set up the shape to point to the right thing.
-  const float kLaserWidth{5.f};
-
-  float xd = m_asteroid->getPos().x - m_miner->getPos().x;
-  float yd = m_asteroid->getPos().y - m_miner->getPos().y;
-
-  // Calculate the distance between the source and destination.
-  float distance = std::sqrtf(xd * xd + yd * yd);
-
-  // Calculate the angle between the source and destination.
-  float angle = std::atan2(yd, xd) * 180.f / 3.1415f;
-
-  m_shape.setPosition(m_miner->getPos());
-  m_shape.setSize(sf::Vector2f{kLaserWidth, distance});
-  m_shape.setOrigin(sf::Vector2f{kLaserWidth / 2.f, 0.f});
-  m_shape.setRotation(angle - 90.f);
+void Miner::onWatchedObjectRemoved(const ObjectHandle& handle) {
+  // One of our asteroids is depleted, so remove the laser pointing to it.
+  m_lasers.erase(std::remove_if(std::begin(m_lasers), std::end(m_lasers),
+                                [&handle](const Laser& laser) {
+                                  return laser.asteroid == handle;
+                                }),
+                 std::end(m_lasers));
 }
 
-Miner::Laser::~Laser() {
+void Miner::hashState(StateHash* hash) const {
+  Structure::hashState(hash);
+  hash->add(m_lastMinedAsteroid);
+  hash->add(m_lasers.size());
+  for (const auto& laser : m_lasers) {
+    hash->add(laser.asteroid.index);
+    hash->add(laser.asteroid.generation);
+  }
 }
 
-void Miner::Laser::draw(sf::RenderTarget& target,
-                        sf::RenderStates states) const {
-  target.draw(m_shape, states);
+void Miner::saveState(BinaryWriter* writer) const {
+  Structure::saveState(writer);
+  writer->write(m_lastMinedAsteroid);
+  writer->write(static_cast<uint32_t>(m_lasers.size()));
+  for (const auto& laser : m_lasers) {
+    writer->write(laser.asteroid.index);
+    writer->write(laser.asteroid.generation);
+  }
 }
 
-void Miner::onObjectRemoved(Object* object) {
-  // We just blindly recreate the lasers to handle the fact that one of our
-  // asteroids might be gone.
-  recreateLasers();
-}
+void Miner::loadState(BinaryReader* reader) {
+  Structure::loadState(reader);
+  reader->read(&m_lastMinedAsteroid);
 
-void Miner::recreateLasers() {
-  // Clear out all the old lasers.
+  // The universe restores who is watching what, so we only need the handles.
+  size_t asteroidCount = 0;
+  reader->readCount(std::numeric_limits<uint32_t>::max(), &asteroidCount);
   m_lasers.clear();
+  for (size_t i = 0; i < asteroidCount && reader->isOk(); ++i) {
+    Laser laser;
+    reader->read(&laser.asteroid.index);
+    reader->read(&laser.asteroid.generation);
+    m_lasers.push_back(laser);
+  }
+}
 
+void Miner::updateLasers() {
   // Find a list of all the astroids in our range.
-  std::vector<Object*> asteroids;
-  m_universe->findObjectsInRadius(std::set<ObjectType>{ObjectType::Asteroid},
-                                  m_pos, 500.f, &asteroids);
-  if (asteroids.empty()) {
-    return;
+  m_asteroidsInRange.clear();
+  m_universe->findObjectsInRadius(ObjectType::Asteroid, m_pos, kMiningRange,
+                                  &m_asteroidsInRange);
+
+  // Keep the lasers on asteroids that are still in range and create lasers
+  // for the new ones.
+  m_updatedLasers.clear();
+  for (auto& asteroid : m_asteroidsInRange) {
+    const ObjectHandle handle = asteroid->getHandle();
+    auto it = std::find_if(
+        std::begin(m_lasers), std::end(m_lasers),
+        [&handle](const Laser& laser) { return laser.asteroid == handle; });
+    if (it != std::end(m_lasers)) {
+      m_updatedLasers.push_back(*it);
+      it->asteroid.reset();
+    } else {
+      Laser laser;
+      laser.asteroid = handle;
+      m_updatedLasers.push_back(laser);
+      m_universe->watchObject(handle, this);
+    }
   }
 
-  // Create lasers for each asteroid in range.
-  for (auto& asteroid : asteroids) {
-    m_lasers.push_back(std::make_unique<Laser>(
-        m_universe, this, static_cast<Asteroid*>(asteroid)));
+  // The lasers that are left point at asteroids that are out of range now.
+  for (const auto& laser : m_lasers) {
+    if (laser.asteroid.isValid()) {
+      m_universe->unwatchObject(laser.asteroid, this);
+    }
   }
+
+  m_lasers.swap(m_updatedLasers);
 }
 
 void Miner::mineAsteroids() {
-  for (auto& laser : m_lasers) {
-    Asteroid* asteroid = laser->getAsteroid();
-    // Mine the asteroid.
-    int32_t amountMined = asteroid->mine(10);
-    m_universe->adjustMinerals(amountMined);
+  // Other miners might be mining the same asteroids, so the universe only
+  // mines them once everyone is done ticking.
+  for (const auto& laser : m_lasers) {
+    m_universe->mineAsteroid(laser.asteroid, 10);
   }
 }
@@ -15,64 +15,63 @@
 #ifndef UNIVERSE_OBJECTS_STRUCTURES_MINER_H_
 #define UNIVERSE_OBJECTS_STRUCTURES_MINER_H_
 
-#include <memory>
+#include <array>
+#include <vector>
 
-#include <SFML/Graphics/CircleShape.hpp>
-#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/System/Vector2.hpp>
 
 #include "universe/objects/structures/structure.h"
-#include "universe/observers.h"
-
-class Asteroid;
+#include "utils/memory_pool.h"
+#include "utils/vertex_builder.h"
 
 class Miner : public Structure {
   DECLARE_STRUCTURE(Miner);
+  DECLARE_POOLED(Miner);
 
 public:
-  Miner(Universe* universe, const sf::Vector2f& pos);
-  virtual ~Miner() override;
-
-  // Override: Object
-  void moveTo(const sf::Vector2f& pos) override;
-  sf::FloatRect getBounds() const override;
-  void tick(float adjustment) override;
-  void draw(sf::RenderTarget& target,
-                    sf::RenderStates states) const override;
-
-private:
-  // A class representing a laser to an asteroid.
-  class Laser : public sf::Drawable {
-  public:
-    Laser(Universe* universe, Miner* miner, Asteroid* asteroid);
-    ~Laser();
+  // The radius of a miner.
+  static const float kRadius;
 
-    // Get the asteroid we are mining.
-    Asteroid* getAsteroid() const { return m_asteroid; }
+  // How far away asteroids can be for us to mine them.
+  static const float kMiningRange;
 
-    // Override: sf::Drawable
-    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+  // The width of a laser beam.
+  static const float kLaserWidth;
 
-  private:
-    // The universe we belong in.
-    Universe* m_universe;
+  // A laser pointing from a miner to an asteroid it is mining.
+  struct Laser {
+    // Return the beam between the given positions of the miner and the
+    // asteroid.
+    const CachedLineQuad& getBeam(
+        const sf::Vector2f& minerPos, const sf::Vector2f& asteroidPos) const;
 
-    // The miner we are lasing from.
-    Miner* m_miner;
+    // The asteroid the laser points at.
+    ObjectHandle asteroid;
 
-    // The asteroid we are mining.
-    Asteroid* m_asteroid;
+    // The beam from the miner to the asteroid.
+    mutable CachedLineQuad beam{-kLaserWidth / 2.f, kLaserWidth / 2.f};
+  };
 
-    // The shape we use to render the laser.
-    sf::RectangleShape m_shape;
+  Miner(Universe* universe, const sf::Vector2f& pos);
+  virtual ~Miner() override;
 
-    DISALLOW_IMPLICIT_CONSTRUCTORS(Laser);
-  };
+  // Get the lasers we have on asteroids.
+  const std::vector<Laser>& getLasers() const { return m_lasers; }
 
-  // Called when the universe removed an object.
-  void onObjectRemoved(Object* object);
+  // Override: Object
+  void moveTo(const sf::Vector2f& pos) override;
+  sf::FloatRect getBounds() const override;
+  void tick(float adjustment) override;
+  void onAddedToUniverse() override;
+  void onWatchedObjectRemoved(const ObjectHandle& handle) override;
+  void hashState(StateHash* hash) const override;
+  void saveState(BinaryWriter* writer) const override;
+  void loadState(BinaryReader* reader) override;
 
-  // Recreate all the lasers pointing to valid minable asteroids.
-  void recreateLasers();
+private:
+  // Point lasers at all the asteroids in range.  Lasers on asteroids that are
+  // still in range are kept as they are.
+  void updateLasers();
 
   // Mine all the asteroids we have lasers on.
   void mineAsteroids();
@@ -80,14 +79,15 @@ private:
   // The time passed since the last time we mined all the asteroids.
   float m_lastMinedAsteroid{0.f};
 
-  // Lasers to asteroids.
-  std::vector<std::unique_ptr<Laser>> m_lasers;
-
-  // Id for the removed object slot.
-  size_t m_removedObjectId;
+  // The lasers we have on asteroids.  We watch every asteroid we have a
+  // laser on, so lasers are only removed when their asteroid is depleted and
+  // only added when we move.
+  std::vector<Laser> m_lasers;
 
-  // The shape we use to render the power generator.
-  sf::CircleShape m_shape;
+  // Scratch space for updateLasers, kept so that moving doesn't allocate once
+  // the lists have grown.
+  std::vector<Object*> m_asteroidsInRange;
+  std::vector<Laser> m_updatedLasers;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(Miner);
 };
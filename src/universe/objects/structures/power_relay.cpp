@@ -14,37 +14,22 @@
 
 #include "universe/objects/structures/power_relay.h"
 
-#include <SFML/Graphics/RenderTarget.hpp>
-
 #include "universe/universe.h"
 
 DEFINE_STRUCTURE(PowerRelay, "Power Relay", 500, 1000);
+DEFINE_POOLED(PowerRelay, 64);
+
+// static
+const float PowerRelay::kRadius = 50.f;
 
 PowerRelay::PowerRelay(Universe* universe, const sf::Vector2f& pos)
-  : Structure(universe, ObjectType::PowerRelay, pos, 500), m_shape(50.f) {
-  m_shape.setFillColor(sf::Color{255, 255, 0, 255});
-  m_shape.setOrigin(m_shape.getGlobalBounds().width / 2.f,
-                    m_shape.getGlobalBounds().height / 2.f);
+  : Structure(universe, ObjectType::PowerRelay, pos, 500) {
 }
 
 PowerRelay::~PowerRelay() {
 }
 
-void PowerRelay::shot(Projectile* projectile) {
-  Structure::shot(projectile);
-
-  m_shape.setFillColor(
-      sf::Color{255, 255, 0, static_cast<sf::Uint8>(255 * m_hitPoints / 500)});
-}
-
 sf::FloatRect PowerRelay::getBounds() const {
-  sf::FloatRect bounds = m_shape.getGlobalBounds();
-  bounds.left += m_pos.x;
-  bounds.top += m_pos.y;
-  return bounds;
-}
-
-void PowerRelay::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-  states.transform.translate(m_pos);
-  target.draw(m_shape, states);
+  return sf::FloatRect{m_pos.x - kRadius, m_pos.y - kRadius, kRadius * 2.f,
+                       kRadius * 2.f};
 }
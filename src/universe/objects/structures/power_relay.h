@@ -15,26 +15,24 @@
 #ifndef UNIVERSE_OBJECTS_STRUCTURES_POWER_RELAY_H_
 #define UNIVERSE_OBJECTS_STRUCTURES_POWER_RELAY_H_
 
-#include <SFML/Graphics/CircleShape.hpp>
-
 #include "universe/objects/structures/structure.h"
+#include "utils/memory_pool.h"
 
 class PowerRelay : public Structure {
   DECLARE_STRUCTURE(PowerRelay);
+  DECLARE_POOLED(PowerRelay);
 
 public:
+  // The radius of a power relay.
+  static const float kRadius;
+
   PowerRelay(Universe* universe, const sf::Vector2f& pos);
   ~PowerRelay() override;
 
   // Override: Object
-  void shot(Projectile* projectile) override;
   sf::FloatRect getBounds() const override;
-  void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
 private:
-  // The shape we use to render the power generator.
-  sf::CircleShape m_shape;
-
   DISALLOW_IMPLICIT_CONSTRUCTORS(PowerRelay);
 };
 
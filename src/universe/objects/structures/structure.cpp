@@ -28,5 +28,6 @@ Structure::~Structure() {
 }
 
 void Structure::tick(float adjustment) {
-  m_universe->adjustPower(getPowerCost());
+  // The power grid keeps track of our power, so there is nothing to do by
+  // default.
 }
@@ -39,6 +39,10 @@ public:
             int32_t hitPoints);
   ~Structure() override;
 
+  // Return the amount of power the structure adds to the grid it is linked
+  // into.  Structures that use up power return a negative amount.
+  virtual int32_t getPowerContribution() { return getPowerCost(); }
+
   // Override: Object
   void tick(float adjustment) override;
 
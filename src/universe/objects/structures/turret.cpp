@@ -14,78 +14,48 @@
 
 #include "universe/objects/structures/turret.h"
 
-#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Transform.hpp>
 
 #include "universe/objects/projectiles/missile.h"
 #include "universe/universe.h"
 #include "utils/math.h"
 
 DEFINE_STRUCTURE(Turret, "Turret", 750, 1000);
+DEFINE_POOLED(Turret, 32);
 
-namespace {
+// static
+const float Turret::kRadius = 50.f;
 
-const float kMaxAttachRange = 2500.f;
-
-}  // namespace
+// static
+const float Turret::kMaxAttachRange = 2500.f;
 
 Turret::Turret(Universe* universe, const sf::Vector2f& pos)
   : Structure(universe, ObjectType::Turret, pos, 500) {
-  // Set up the base shape.
-  {
-    m_baseShape.setRadius(50.f);
-    m_baseShape.setFillColor(sf::Color{0, 255, 0, 255});
-    sf::FloatRect bounds = m_baseShape.getLocalBounds();
-    m_baseShape.setOrigin(bounds.width / 2.f, bounds.height / 2.f);
-  }
-
-  // Set up the turret shape.
-  {
-    m_launcherRailShape.setSize(sf::Vector2f{20.f, 40.f});
-    m_launcherRailShape.setFillColor(sf::Color{0, 127, 0, 255});
-    sf::FloatRect bounds = m_launcherRailShape.getLocalBounds();
-    m_launcherRailShape.setOrigin(bounds.width / 2.f, bounds.height / 2.f);
-  }
-
-  // Create our 3 missiles.
-  for (auto& missile : m_missiles) {
-    missile = static_cast<Missile*>(m_universe->addObject(
-        std::make_unique<Missile>(m_universe, m_pos, m_turretDirection)));
-  }
-
-  m_removedObjectSlotId = m_universe->getObjectRemovedSignal().connect(
-      nu::slot(&Turret::onObjectRemoved, this));
 }
 
 Turret::~Turret() {
-  m_universe->getObjectRemovedSignal().disconnect(m_removedObjectSlotId);
-
   // If we die and we have missiles on the rail, then our missiles die too.
-  for (auto& missile : m_missiles) {
+  for (auto& handle : m_missiles) {
+    Missile* missile = static_cast<Missile*>(m_universe->resolve(handle));
     if (missile && !missile->isLaunched()) {
       m_universe->removeObject(missile);
     }
   }
 }
 
-void Turret::shot(Projectile* projectile) {
-  Structure::shot(projectile);
-
-  m_baseShape.setFillColor(
-      sf::Color{0, 255, 0, static_cast<sf::Uint8>(255 * m_hitPoints / 500)});
-}
-
 void Turret::moveTo(const sf::Vector2f& pos) {
   Structure::moveTo(pos);
-  for (auto& missile : m_missiles) {
-    missile->moveTo(pos);
+  for (auto& handle : m_missiles) {
+    Object* missile = m_universe->resolve(handle);
+    if (missile) {
+      missile->moveTo(pos);
+    }
   }
 }
 
 sf::FloatRect Turret::getBounds() const {
-  sf::FloatRect bounds = m_baseShape.getGlobalBounds();
-  bounds.left += m_pos.x;
-  bounds.top += m_pos.y;
-  return bounds;
+  return sf::FloatRect{m_pos.x - kRadius, m_pos.y - kRadius, kRadius * 2.f,
+                       kRadius * 2.f};
 }
 
 void Turret::tick(float adjustment) {
@@ -95,21 +65,33 @@ void Turret::tick(float adjustment) {
     // Turn the rails as if they are searching for a target.
     turnRail(m_turretDirection + 1.f * adjustment);
 
-    m_target = findBestTarget();
-    if (m_target) {
+    // Just attack the closest enemy ship for now.
+    Object* target = m_offeredTarget;
+    m_offeredTarget = nullptr;
+    if (target) {
+      m_target = target->getHandle();
+      m_universe->watchObject(m_target, this);
       m_task = Task::Attacking;
     }
   }
 
   if (m_task == Task::Attacking) {
-    float directionToTarget = directionBetween(m_pos, m_target->getPos());
+    Object* target = m_universe->resolve(m_target);
+    if (!target) {
+      // Our target is gone, so go back to searching.
+      m_target.reset();
+      m_task = Task::Idle;
+      return;
+    }
+
+    float directionToTarget = directionBetween(m_pos, target->getPos());
 
     // Snap the turret to the target for now.  In future we should have a max
     // turn radius.
     turnRail(directionToTarget);
 
     if (m_timeSinceLastShot > 100.f) {
-      shoot();
+      shoot(target);
       m_timeSinceLastShot = 0.f;
     } else {
       m_timeSinceLastShot += adjustment;
@@ -117,69 +99,134 @@ void Turret::tick(float adjustment) {
   }
 }
 
-void Turret::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-  states.transform.translate(m_pos);
-  target.draw(m_baseShape, states);
-  target.draw(m_launcherRailShape, states);
+void Turret::onAddedToUniverse() {
+  // Our 3 missiles are only created once we are in the universe, so that
+  // ghost turrets that are still being placed don't add any objects.
+  for (auto& missile : m_missiles) {
+    missile = createMissile();
+  }
 }
 
-Object* Turret::findBestTarget() {
-  // Just find the closest enemy ship for now.
-  return m_universe->findClosestObjectOfType(m_pos, ObjectType::EnemyShip,
-                                             kMaxAttachRange);
+ObjectHandle Turret::createMissile() {
+  Object* missile = m_universe->addObject(
+      std::make_unique<Missile>(m_universe, m_pos, m_turretDirection));
+  if (!missile) {
+    return ObjectHandle{};
+  }
+
+  // We want to know when our missiles are gone so that we can reload.
+  m_universe->watchObject(missile->getHandle(), this);
+
+  return missile->getHandle();
 }
 
-void Turret::turnRail(float direction) {
-  m_turretDirection = direction;
-  m_launcherRailShape.setRotation(m_turretDirection);
+void Turret::placeMissilesOnRail() {
+  sf::Transform transform;
+  transform.rotate(m_turretDirection);
 
   for (size_t i = 0; i < m_missiles.size(); ++i) {
-    // If the missile has been launched, we don't have control over it any more.
-    if (m_missiles[i]->isLaunched()) {
+    Missile* missile =
+        static_cast<Missile*>(m_universe->resolve(m_missiles[i]));
+
+    // If the missile has been launched, we don't have control over it any
+    // more.
+    if (!missile || missile->isLaunched()) {
       continue;
     }
 
-    sf::Transform transform;
-    transform.rotate(direction);
-    m_missiles[i]->moveTo(
+    missile->moveTo(
         m_pos +
         transform.transformPoint(
             0.f, static_cast<float>(static_cast<int32_t>(i) - 1) * 15.f));
-    m_missiles[i]->setDirection(direction);
+    missile->setDirection(m_turretDirection);
   }
 }
 
-void Turret::shoot() {
-  // DCHECK(m_target) << "To launch a missile we need a target.";
+void Turret::launchMissileAt(const ObjectHandle& targetHandle) {
+  Object* target = m_universe->resolve(targetHandle);
+  if (!target) {
+    return;
+  }
 
-  // Find a missile that we can launch.
-  Missile* ready = nullptr;
-  for (size_t i = 0; i < m_missiles.size(); ++i) {
-    if (m_missiles[i] && !m_missiles[i]->isLaunched()) {
-      ready = m_missiles[i];
-      break;
+  for (auto& handle : m_missiles) {
+    Missile* missile = static_cast<Missile*>(m_universe->resolve(handle));
+    if (missile && !missile->isLaunched()) {
+      missile->launchAt(target);
+      return;
     }
   }
+}
+
+void Turret::turnRail(float direction) {
+  m_turretDirection = direction;
+
+  // The missiles are objects of their own, so they are only moved once all the
+  // objects are done ticking.
+  m_universe->placeRailMissiles(this);
+}
+
+void Turret::shoot(Object* target) {
+  // The missiles are only launched once all the objects are done ticking.
+  m_universe->launchMissile(this, target->getHandle());
+}
 
-  if (ready) {
-    ready->launchAt(m_target);
+void Turret::hashState(StateHash* hash) const {
+  Structure::hashState(hash);
+  hash->add(m_task);
+  hash->add(m_turretDirection);
+  hash->add(m_target.index);
+  hash->add(m_target.generation);
+  hash->add(m_timeSinceLastShot);
+  for (const auto& missile : m_missiles) {
+    hash->add(missile.index);
+    hash->add(missile.generation);
   }
 }
 
-void Turret::onObjectRemoved(Object* object) {
+void Turret::saveState(BinaryWriter* writer) const {
+  Structure::saveState(writer);
+  writer->write(m_turretDirection);
+  writer->write(m_target.index);
+  writer->write(m_target.generation);
+  writer->write(m_task);
+  writer->write(m_timeSinceLastShot);
+  for (const auto& missile : m_missiles) {
+    writer->write(missile.index);
+    writer->write(missile.generation);
+  }
+}
+
+void Turret::loadState(BinaryReader* reader) {
+  Structure::loadState(reader);
+  reader->read(&m_turretDirection);
+  reader->read(&m_target.index);
+  reader->read(&m_target.generation);
+  if (!reader->read(&m_task) || m_task > Task::Attacking) {
+    reader->fail();
+  }
+  reader->read(&m_timeSinceLastShot);
+
+  // The missiles on our rail are objects of their own and are loaded
+  // separately, so we only need their handles.
+  for (auto& missile : m_missiles) {
+    reader->read(&missile.index);
+    reader->read(&missile.generation);
+  }
+}
+
+void Turret::onWatchedObjectRemoved(const ObjectHandle& handle) {
   // If the object is one of our missiles, then we should create a missile in
   // it's place.
-  for (size_t i = 0; i < m_missiles.size(); ++i) {
-    if (m_missiles[i] == object) {
-      m_missiles[i] = static_cast<Missile*>(m_universe->addObject(
-          std::make_unique<Missile>(m_universe, m_pos, m_turretDirection)));
+  for (auto& missile : m_missiles) {
+    if (missile == handle) {
+      missile = createMissile();
     }
   }
 
   // If the object that is about to removed is our target, then we need a new
   // target.
-  if (object == m_target) {
-    m_target = nullptr;
+  if (handle == m_target) {
+    m_target.reset();
 
     // Go back to idle so that we can select a new target.
     m_task = Task::Idle;
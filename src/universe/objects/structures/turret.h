@@ -17,27 +17,54 @@
 
 #include <array>
 
-#include <SFML/Graphics/CircleShape.hpp>
-#include <SFML/Graphics/RectangleShape.hpp>
-
 #include "universe/objects/structures/structure.h"
-#include "universe/observers.h"
+#include "utils/memory_pool.h"
 
 class Missile;
 
 class Turret : public Structure {
   DECLARE_STRUCTURE(Turret);
+  DECLARE_POOLED(Turret);
 
 public:
+  // The radius of the turret base.
+  static const float kRadius;
+
+  // The furthest away a target can be for us to attack it.
+  static const float kMaxAttachRange;
+
   Turret(Universe* universe, const sf::Vector2f& pos);
   ~Turret() override;
 
+  // Get the direction the launcher rail is facing.
+  float getDirection() const { return m_turretDirection; }
+
+  // Returns true if we are looking for something to attack.
+  bool isSearchingForTarget() const { return m_task == Task::Idle; }
+
+  // Give us the closest target within range, or null if there is none.  The
+  // universe finds targets for all the turrets that are searching in one pass
+  // right before they are ticked, so the target is only good for the next
+  // tick.
+  void offerTarget(Object* target) { m_offeredTarget = target; }
+
+  // Move the missiles that are still on our rail into place for the direction
+  // we are facing.  See Universe::placeRailMissiles.
+  void placeMissilesOnRail();
+
+  // Launch the first missile that is still on our rail at the target, if the
+  // target is still around.  See Universe::launchMissile.
+  void launchMissileAt(const ObjectHandle& target);
+
   // Override: Object
-  void shot(Projectile* projectile) override;
   void moveTo(const sf::Vector2f& pos) override;
   sf::FloatRect getBounds() const override;
   void tick(float adjustment) override;
-  void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+  void onAddedToUniverse() override;
+  void onWatchedObjectRemoved(const ObjectHandle& handle) override;
+  void hashState(StateHash* hash) const override;
+  void saveState(BinaryWriter* writer) const override;
+  void loadState(BinaryReader* reader) override;
 
 private:
   enum class Task {
@@ -45,23 +72,25 @@ private:
     Attacking,
   };
 
-  // Find the best target to shoot at.
-  Object* findBestTarget();
+  // Add a new missile to the universe and return its handle.
+  ObjectHandle createMissile();
 
-  // Move the missiles into their positions on the rail.
+  // Turn to face the given direction and move the missiles into their
+  // positions on the rail.
   void turnRail(float degrees);
 
-  // Shoot the gun.
-  void shoot();
-
-  // Called when the universe removed an object.
-  void onObjectRemoved(Object* object);
+  // Launch a missile at the target.
+  void shoot(Object* target);
 
   // The direction the turret is facing.
   float m_turretDirection{0.f};
 
   // The current target we are shooting at.
-  Object* m_target{nullptr};
+  ObjectHandle m_target;
+
+  // The target the universe found for us for this tick while we are
+  // searching.
+  Object* m_offeredTarget{nullptr};
 
   // The current task we are performing.
   Task m_task{Task::Idle};
@@ -70,16 +99,7 @@ private:
   float m_timeSinceLastShot{0.f};
 
   // We have 3 missiles.
-  std::array<Missile*, 3> m_missiles;
-
-  // The RemovedObject slot id.
-  size_t m_removedObjectSlotId;
-
-  // The shape we use to render the base of the turret.
-  sf::CircleShape m_baseShape;
-
-  // The shape we use to render the turret.
-  sf::RectangleShape m_launcherRailShape;
+  std::array<ObjectHandle, 3> m_missiles;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(Turret);
 };
@@ -14,17 +14,14 @@
 
 #include "universe/objects/units/enemy_ship.h"
 
-#include <functional>
 #include <sstream>
 
 #include <nucleus/logging.h>
-#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Transform.hpp>
 
-#include "universe/objects/projectiles/bullet.h"
 #include "universe/universe.h"
 #include "utils/math.h"
 #include "utils/stream_operators.h"
-#include "particles/particle.h"
 
 namespace {
 
@@ -35,52 +32,73 @@ const float kMaxEngagementRange = 750.f;
 
 }  // namespace
 
+DEFINE_POOLED(EnemyShip, 64);
+
 EnemyShip::EnemyShip(Universe* universe, const sf::Vector2f& pos)
   : Unit(universe, ObjectType::EnemyShip, pos, 250),
-    m_smokeEmitter(std::bind(&EnemyShip::createSmokeParticle, this,
-                             std::placeholders::_1, std::placeholders::_2)) {
-  // Set up the shape of the ship.
-  m_shape.setPrimitiveType(sf::Triangles);
-  m_shape.append(
-      sf::Vertex{sf::Vector2f{0.f, -25.f}, sf::Color{255, 0, 0, 255}});
-  m_shape.append(
-      sf::Vertex{sf::Vector2f{75.f, 0.f}, sf::Color{255, 0, 0, 255}});
-  m_shape.append(
-      sf::Vertex{sf::Vector2f{0.f, 25.f}, sf::Color{255, 0, 0, 255}});
-
-#if BUILD(DEBUG)
-  // Set up the info text.
-  sf::Font* font =
-      universe->getResourceManager()->getFont(ResourceManager::Font::Default);
-  if (font) {
-    m_infoText.setFont(*font);
-    m_infoText.setColor(sf::Color{255, 255, 255, 255});
-    m_infoText.setCharacterSize(20);
-    m_infoText.setString("Nothing to say");
-  }
-#endif  // BUILD(DEBUG)
-
-  createEngagementRangeShape();
-
-  objectRemovedId = m_universe->getObjectRemovedSignal().connect(
-      nu::slot(&EnemyShip::onObjectRemoved, this));
+    m_smokeEmitter(universe->getParticleSystem(),
+                   ParticleEmitter::Settings{}) {
 }
 
 EnemyShip::~EnemyShip() {
-  m_universe->getObjectRemovedSignal().disconnect(objectRemovedId);
 }
 
 void EnemyShip::setTarget(Object* target) {
-  m_target = target;
+  // We only want to know when our current target is destroyed.
+  m_universe->unwatchObject(m_target, this);
+
+  if (target) {
+    m_target = target->getHandle();
+    m_universe->watchObject(m_target, this);
+  } else {
+    m_target.reset();
+  }
   m_task = Task::Nothing;
 }
 
+#if BUILD(DEBUG)
+std::string EnemyShip::getDebugInfo() const {
+  std::ostringstream ss;
+
+  switch (m_task) {
+    case Task::Nothing:
+      ss << "Nothing";
+      break;
+
+    case Task::Travel:
+      ss << "Travel";
+      break;
+
+    case Task::Attacking:
+      ss << "Attacking";
+      break;
+
+    case Task::Egress:
+      ss << "Egress";
+      break;
+
+    default:
+      ss << "Unknown";
+      break;
+  }
+
+  ss << '\n' << m_direction << " ("
+     << directionBetween(m_pos, m_travelTargetPos) << ")\n"
+     << distanceBetween(m_pos, m_travelTargetPos);
+
+  return ss.str();
+}
+#endif  // BUILD(DEBUG)
+
 void EnemyShip::shot(Projectile* projectile) {
   Unit::shot(projectile);
 }
 
 sf::FloatRect EnemyShip::getBounds() const {
-  return m_shape.getBounds();
+  sf::Transform transform;
+  transform.translate(m_pos);
+  transform.rotate(m_direction);
+  return transform.transformRect(sf::FloatRect{0.f, -25.f, 75.f, 50.f});
 }
 
 void EnemyShip::tick(float adjustment) {
@@ -99,15 +117,17 @@ void EnemyShip::tick(float adjustment) {
   if (m_task == Task::Nothing) {
     // We have nothing to do, so select the best target to attack and travel
     // there.
+    Object* target = selectBestTarget();
+    setTarget(target);
     m_task = Task::Travel;
-    m_target = selectBestTarget();
-    if (m_target) {
-      m_travelTargetPos = m_target->getPos();
+
+    if (target) {
+      m_travelTargetPos = target->getPos();
     }
   }
 
   // If we don't have a target, we don't know what to do.
-  if (!m_target) {
+  if (!m_universe->resolve(m_target)) {
     return;
   }
 
@@ -117,6 +137,7 @@ void EnemyShip::tick(float adjustment) {
     const float directionToTarget = directionBetween(m_pos, m_travelTargetPos);
 
     // If we are not pointing directly towards the target, then we must turn.
+    const float maxTurn = kMaxTurnRadius * adjustment;
     if (m_direction != directionToTarget) {
       const float leftDiff =
           wrap(360.f - directionToTarget + m_direction, 0.f, 360.f);
@@ -124,15 +145,15 @@ void EnemyShip::tick(float adjustment) {
 
       // Figure out which way to turn.
       const float turnSide =
-          (leftDiff < rightDiff) ? -kMaxTurnRadius : kMaxTurnRadius;
+          (leftDiff < rightDiff) ? -maxTurn : maxTurn;
 
       // Adjust the direction towards the target.
       m_direction = wrap(m_direction + turnSide, 0.f, 360.f);
 
-      // If the direction is within kMaxTurnRadius of the target direction, then
-      // snap it directly to the target, to avoid oscillation.
+      // If the direction is within a turn of the target direction, then snap
+      // it directly to the target, to avoid oscillation.
       if (std::abs(wrap(m_direction - directionToTarget, 0.f, 360.f)) <
-          kMaxTurnRadius) {
+          maxTurn) {
         m_direction = directionToTarget;
       }
     }
@@ -140,8 +161,7 @@ void EnemyShip::tick(float adjustment) {
     m_speed = kMaxTravelSpeed;
 
     // If we have speed, update our position.
-    m_pos = sf::Vector2f{m_pos.x + std::cos(degToRad(m_direction)) * m_speed,
-                         m_pos.y + std::sin(degToRad(m_direction)) * m_speed};
+    setPos(m_pos + vectorInDirection(m_direction, m_speed * adjustment));
 
     // If we are heading directly towards the target and the target comes into
     // range, then we start our attack run.
@@ -169,8 +189,7 @@ void EnemyShip::tick(float adjustment) {
     m_speed = kMaxAttackSpeed;
 
     // If we have speed, update our position.
-    m_pos = sf::Vector2f{m_pos.x + std::cos(degToRad(m_direction)) * m_speed,
-                         m_pos.y + std::sin(degToRad(m_direction)) * m_speed};
+    setPos(m_pos + vectorInDirection(m_direction, m_speed * adjustment));
 
     const float directionToTarget = directionBetween(m_pos, m_travelTargetPos);
     if (std::abs(directionToTarget - m_direction) > kMaxTurnRadius) {
@@ -181,69 +200,16 @@ void EnemyShip::tick(float adjustment) {
 
   if (m_task == Task::Egress) {
     m_speed = kMaxTravelSpeed;
-    m_direction = wrap(m_direction -= kMaxTurnRadius / 3.f, 0.f, 360.f);
+    m_direction =
+        wrap(m_direction - kMaxTurnRadius / 3.f * adjustment, 0.f, 360.f);
     // If we have speed, update our position.
-    m_pos = sf::Vector2f{m_pos.x + std::cos(degToRad(m_direction)) * m_speed,
-                         m_pos.y + std::sin(degToRad(m_direction)) * m_speed};
+    setPos(m_pos + vectorInDirection(m_direction, m_speed * adjustment));
 
     const float distanceToTarget = distanceBetween(m_pos, m_travelTargetPos);
     if (distanceToTarget > kMaxEngagementRange * 1.5f) {
       m_task = Task::Nothing;
     }
   }
-
-#if BUILD(DEBUG)
-  {
-    std::ostringstream ss;
-
-    switch (m_task) {
-      case Task::Nothing:
-        ss << "Nothing";
-        break;
-
-      case Task::Travel:
-        ss << "Travel";
-        break;
-
-      case Task::Attacking:
-        ss << "Attacking";
-        break;
-
-      case Task::Egress:
-        ss << "Egress";
-        break;
-
-      default:
-        ss << "Unknown";
-        break;
-    }
-
-    ss << '\n' << m_direction << " ("
-       << directionBetween(m_pos, m_travelTargetPos) << ")\n"
-       << distanceBetween(m_pos, m_travelTargetPos);
-
-    m_infoText.setString(ss.str());
-    m_infoText.setPosition(m_pos);
-    sf::FloatRect bounds{m_infoText.getLocalBounds()};
-    m_infoText.setOrigin(sf::Vector2f{bounds.width / 2.f, bounds.height / 2.f});
-  }
-#endif
-}
-
-void EnemyShip::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-  sf::RenderStates originalStates{states};
-
-  // Draw the particles first.
-  target.draw(m_smokeEmitter, states);
-
-  states.transform.translate(m_pos);
-  states.transform.rotate(m_direction);
-  // target.draw(m_engagementRangeShape, states);
-  target.draw(m_shape, states);
-
-#if BUILD(DEBUG)
-  target.draw(m_infoText, originalStates);
-#endif
 }
 
 Object* EnemyShip::selectBestTarget() {
@@ -273,45 +239,50 @@ Object* EnemyShip::selectBestTarget() {
   return m_universe->findClosestObjectOfType(m_pos, ObjectType::CommandCenter);
 }
 
-void EnemyShip::createEngagementRangeShape() {
-  const float kSpread = 45.f;
-  const int kSteps = 9;
-  static const sf::Color color{255, 0, 0, 127};
-
-  m_engagementRangeShape.setPrimitiveType(sf::TrianglesFan);
-  m_engagementRangeShape.resize(2 + kSteps);
-
-  m_engagementRangeShape[0].position = sf::Vector2f(75.f, 0.f);
-  m_engagementRangeShape[0].color = color;
-
-  size_t i = 1;
-  const float spreadStep = kSpread / static_cast<float>(kSteps);
-  const float half = kSpread / -2.f;
-  for (float degrees = 0.f; degrees <= kSpread; degrees += spreadStep, ++i) {
-    m_engagementRangeShape[i].position.x =
-        std::cos(degToRad(half + degrees)) * kMaxEngagementRange;
-    m_engagementRangeShape[i].position.y =
-        std::sin(degToRad(half + degrees)) * kMaxEngagementRange;
-    m_engagementRangeShape[i].color = color;
-  }
+void EnemyShip::shoot() {
+  // The bullet is added once all the objects are done ticking.
+  m_universe->spawnBullet(m_pos, m_direction, m_speed * 2.f);
 }
 
-void EnemyShip::shoot() {
-  auto bullet =
-      std::make_unique<Bullet>(m_universe, m_pos, m_direction, m_speed * 2.f);
-  m_universe->addObject(std::move(bullet));
+void EnemyShip::hashState(StateHash* hash) const {
+  Unit::hashState(hash);
+  hash->add(m_task);
+  hash->add(m_direction);
+  hash->add(m_speed);
+  hash->add(m_target.index);
+  hash->add(m_target.generation);
+  hash->add(m_travelTargetPos);
+  hash->add(m_timeSinceLastShot);
 }
 
-void EnemyShip::onObjectRemoved(Object* object) {
-  // If our target was removed, then we should do something else.
-  if (object == m_target) {
-    m_target = nullptr;
-    m_task = Task::Nothing;
+void EnemyShip::saveState(BinaryWriter* writer) const {
+  Unit::saveState(writer);
+  writer->write(m_task);
+  writer->write(m_direction);
+  writer->write(m_speed);
+  writer->write(m_target.index);
+  writer->write(m_target.generation);
+  writer->write(m_travelTargetPos);
+  writer->write(m_timeSinceLastShot);
+}
+
+void EnemyShip::loadState(BinaryReader* reader) {
+  Unit::loadState(reader);
+  if (!reader->read(&m_task) || m_task > Task::Egress) {
+    reader->fail();
   }
+  reader->read(&m_direction);
+  reader->read(&m_speed);
+  reader->read(&m_target.index);
+  reader->read(&m_target.generation);
+  reader->read(&m_travelTargetPos);
+  reader->read(&m_timeSinceLastShot);
 }
 
-Particle* EnemyShip::createSmokeParticle(ParticleEmitter* emitter,
-                                         const sf::Vector2f& pos) {
-  auto particle = std::make_unique<Particle>(emitter, pos);
-  return particle.release();
+void EnemyShip::onWatchedObjectRemoved(const ObjectHandle& handle) {
+  // If our target was removed, then we should do something else.
+  if (handle == m_target) {
+    m_target.reset();
+    m_task = Task::Nothing;
+  }
 }
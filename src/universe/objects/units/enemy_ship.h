@@ -17,14 +17,16 @@
 
 #include "universe/objects/units/unit.h"
 
-#include <nucleus/config.h>
+#include <string>
 
-#include <SFML/Graphics/Text.hpp>
-#include <SFML/Graphics/VertexArray.hpp>
+#include <nucleus/config.h>
 
 #include "particles/particle_emitter.h"
+#include "utils/memory_pool.h"
 
 class EnemyShip : public Unit {
+  DECLARE_POOLED(EnemyShip);
+
 public:
   EnemyShip(Universe* universe, const sf::Vector2f& pos);
   ~EnemyShip() override;
@@ -32,11 +34,22 @@ public:
   // Set the current target for the ship.
   void setTarget(Object* target);
 
+  // Get the direction the ship is facing.
+  float getDirection() const { return m_direction; }
+
+#if BUILD(DEBUG)
+  // Return a description of what the ship is currently doing.
+  std::string getDebugInfo() const;
+#endif  // BUILD(DEBUG)
+
   // Override: Unit
   void shot(Projectile* projectile) override;
   sf::FloatRect getBounds() const override;
   void tick(float adjustment) override;
-  void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+  void onWatchedObjectRemoved(const ObjectHandle& handle) override;
+  void hashState(StateHash* hash) const override;
+  void saveState(BinaryWriter* writer) const override;
+  void loadState(BinaryReader* reader) override;
 
 private:
   enum class Task {
@@ -49,25 +62,9 @@ private:
   // From our current position, select the best target to attack.
   Object* selectBestTarget();
 
-  // Create the shape that we use to show the engagement envelope of the ship.
-  void createEngagementRangeShape();
-
   // Shoot a projectile at the target.
   void shoot();
 
-  // Called when the universe removed an object.
-  void onObjectRemoved(Object* object);
-
-  // Factory function to create a smoke particle.
-  Particle* createSmokeParticle(ParticleEmitter* emitter,
-                                const sf::Vector2f& pos);
-
-  // The shape we use to render the ship.
-  sf::VertexArray m_shape;
-
-  // A shape used to show the engagement envelope of the ship.
-  sf::VertexArray m_engagementRangeShape;
-
   // Particle emitter to render the smoke trail.
   ParticleEmitter m_smokeEmitter;
 
@@ -81,7 +78,7 @@ private:
   float m_speed{0.f};
 
   // The object we are attacking.
-  Object* m_target;
+  ObjectHandle m_target;
 
   // The current target that we are travelling towards.
   sf::Vector2f m_travelTargetPos;
@@ -89,15 +86,8 @@ private:
   // Ticks since the last time we fired a shot.
   float m_timeSinceLastShot{0.f};
 
-#if BUILD(DEBUG)
-  // Info text that we print out with the ship.
-  sf::Text m_infoText;
-#endif  // BUILD(DEBUG)
-
   int stepper{0};
 
-  size_t objectRemovedId;
-
   DISALLOW_IMPLICIT_CONSTRUCTORS(EnemyShip);
 };
 
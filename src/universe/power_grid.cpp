@@ -0,0 +1,301 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#include "universe/power_grid.h"
+
+#include <algorithm>
+
+#include <nucleus/logging.h>
+
+#include "universe/link.h"
+#include "universe/objects/object.h"
+#include "universe/objects/structures/structure.h"
+#include "universe/universe.h"
+
+namespace {
+
+// Return the structure on the other side of the link.
+Object* otherEndOf(const Link* link, const Object* structure) {
+  return link->getSource() == structure ? link->getDestination()
+                                        : link->getSource();
+}
+
+}  // namespace
+
+// static
+const float PowerGrid::kLinkRange = 1500.f;
+
+PowerGrid::PowerGrid(Universe* universe) : m_universe(universe) {
+}
+
+PowerGrid::~PowerGrid() {
+  clear();
+}
+
+const std::vector<Link*>& PowerGrid::getLinksFor(
+    const Object* structure) const {
+  return nodeFor(structure).links;
+}
+
+void PowerGrid::addStructure(Object* structure) {
+  DCHECK(Object::isStructure(structure));
+
+  const uint32_t index = structure->getHandle().index;
+  if (index >= m_nodes.size()) {
+    m_nodes.resize(index + 1);
+  }
+
+  Node& node = m_nodes[index];
+  DCHECK(!node.structure) << "Structure is already in the grid.";
+  node.structure = structure;
+  node.links.clear();
+  node.parent = index;
+  node.rank = 0;
+  node.power = static_cast<Structure*>(structure)->getPowerContribution();
+  node.componentPower = node.power;
+
+  m_totalPower += node.power;
+}
+
+void PowerGrid::linkStructure(Object* structure) {
+  if (structure->getType() != ObjectType::PowerRelay) {
+    linkToClosestRelay(structure);
+    return;
+  }
+
+  // Link to every power relay in range and pick up the structures that don't
+  // have a power relay yet.
+  std::vector<Object*> structuresInRange;
+  m_universe->findObjectsInRadius(Object::objectTypesForStructures(),
+                                  structure->getPos(), kLinkRange,
+                                  &structuresInRange);
+
+  for (auto& other : structuresInRange) {
+    if (other == structure) {
+      continue;
+    }
+
+    if (other->getType() == ObjectType::PowerRelay) {
+      addLink(structure, other);
+    } else if (nodeFor(other).links.empty()) {
+      addLink(other, structure);
+    }
+  }
+}
+
+void PowerGrid::removeStructure(Object* structure) {
+  Node& node = nodeFor(structure);
+  DCHECK(node.structure == structure) << "Structure is not in the grid.";
+
+  m_totalPower -= node.power;
+
+  // Other nodes might have this one as their parent and our power is part of
+  // theirs, so the sets have to be rebuilt if we had any links.
+  if (!node.links.empty()) {
+    m_componentsDirty = true;
+  }
+
+  // Go through the links in the order the grid keeps them in.  The order of
+  // each structure's own links depends on what happened to its neighbours and
+  // is not kept by snapshots, so it must not decide the order the links are
+  // deleted and the orphans are linked again in.
+  std::sort(std::begin(node.links), std::end(node.links),
+            [](const Link* left, const Link* right) {
+              return left->m_gridIndex < right->m_gridIndex;
+            });
+
+  m_orphans.clear();
+  for (auto& link : node.links) {
+    Object* other = otherEndOf(link, structure);
+
+    std::vector<Link*>& otherLinks = nodeFor(other).links;
+    auto it = std::find(std::begin(otherLinks), std::end(otherLinks), link);
+    if (it != std::end(otherLinks)) {
+      *it = otherLinks.back();
+      otherLinks.pop_back();
+    }
+
+    if (other->getType() != ObjectType::PowerRelay && otherLinks.empty()) {
+      m_orphans.push_back(other);
+    }
+
+    deleteLink(link);
+  }
+
+  node.links.clear();
+  node.structure = nullptr;
+  node.power = 0;
+
+  // Find a new power relay for the structures that were linked to us.
+  for (auto& orphan : m_orphans) {
+    linkToClosestRelay(orphan);
+  }
+}
+
+Link* PowerGrid::addLink(Object* source, Object* destination) {
+  DCHECK(source != destination) << "Can't link a structure to itself.";
+
+  if (!m_linkKeys.insert(linkKeyFor(source, destination)).second) {
+    return nullptr;
+  }
+
+  Link* link = new Link{m_universe, source, destination};
+  link->m_gridIndex = m_links.size();
+  m_links.push_back(link);
+
+  nodeFor(source).links.push_back(link);
+  nodeFor(destination).links.push_back(link);
+
+  if (!m_componentsDirty) {
+    unite(source->getHandle().index, destination->getHandle().index);
+  }
+
+  return link;
+}
+
+bool PowerGrid::hasLink(const Object* left, const Object* right) const {
+  return m_linkKeys.count(linkKeyFor(left, right)) != 0;
+}
+
+uint32_t PowerGrid::getComponent(const Object* structure) {
+  return findComponentRoot(structure);
+}
+
+bool PowerGrid::areConnected(const Object* left, const Object* right) {
+  return getComponent(left) == getComponent(right);
+}
+
+int32_t PowerGrid::getComponentPower(const Object* structure) {
+  return m_nodes[findComponentRoot(structure)].componentPower;
+}
+
+bool PowerGrid::isPowered(const Object* structure) {
+  return getComponentPower(structure) >= 0;
+}
+
+void PowerGrid::findUnpoweredStructures(std::vector<Object*>* structuresOut) {
+  DCHECK(structuresOut);
+
+  if (m_componentsDirty) {
+    rebuildComponents();
+  }
+
+  for (uint32_t i = 0; i < m_nodes.size(); ++i) {
+    if (m_nodes[i].structure && m_nodes[findRoot(i)].componentPower < 0) {
+      structuresOut->push_back(m_nodes[i].structure);
+    }
+  }
+}
+
+void PowerGrid::clear() {
+  for (auto& link : m_links) {
+    delete link;
+  }
+  m_links.clear();
+  m_linkKeys.clear();
+  m_nodes.clear();
+  m_componentsDirty = false;
+  m_totalPower = 0;
+}
+
+// static
+uint64_t PowerGrid::linkKeyFor(const Object* left, const Object* right) {
+  const uint64_t leftIndex = left->getHandle().index;
+  const uint64_t rightIndex = right->getHandle().index;
+  return (std::min(leftIndex, rightIndex) << 32) |
+         std::max(leftIndex, rightIndex);
+}
+
+PowerGrid::Node& PowerGrid::nodeFor(const Object* structure) {
+  DCHECK(structure->getHandle().index < m_nodes.size());
+  return m_nodes[structure->getHandle().index];
+}
+
+const PowerGrid::Node& PowerGrid::nodeFor(const Object* structure) const {
+  DCHECK(structure->getHandle().index < m_nodes.size());
+  return m_nodes[structure->getHandle().index];
+}
+
+void PowerGrid::linkToClosestRelay(Object* structure) {
+  Object* relay = m_universe->findClosestObjectOfType(
+      structure->getPos(), ObjectType::PowerRelay, kLinkRange);
+  if (relay) {
+    addLink(structure, relay);
+  }
+}
+
+void PowerGrid::deleteLink(Link* link) {
+  m_linkKeys.erase(linkKeyFor(link->getSource(), link->getDestination()));
+
+  // Move the last link into the free spot.
+  Link* last = m_links.back();
+  m_links[link->m_gridIndex] = last;
+  last->m_gridIndex = link->m_gridIndex;
+  m_links.pop_back();
+
+  delete link;
+}
+
+uint32_t PowerGrid::findRoot(uint32_t index) {
+  while (m_nodes[index].parent != index) {
+    // Point every other node on the path to its grandparent.
+    m_nodes[index].parent = m_nodes[m_nodes[index].parent].parent;
+    index = m_nodes[index].parent;
+  }
+  return index;
+}
+
+void PowerGrid::unite(uint32_t left, uint32_t right) {
+  left = findRoot(left);
+  right = findRoot(right);
+  if (left == right) {
+    return;
+  }
+
+  // Hang the shallower tree under the deeper one.
+  if (m_nodes[left].rank < m_nodes[right].rank) {
+    std::swap(left, right);
+  }
+  m_nodes[right].parent = left;
+  m_nodes[left].componentPower += m_nodes[right].componentPower;
+  if (m_nodes[left].rank == m_nodes[right].rank) {
+    ++m_nodes[left].rank;
+  }
+}
+
+void PowerGrid::rebuildComponents() {
+  for (uint32_t i = 0; i < m_nodes.size(); ++i) {
+    m_nodes[i].parent = i;
+    m_nodes[i].rank = 0;
+    m_nodes[i].componentPower = m_nodes[i].power;
+  }
+
+  for (const auto& link : m_links) {
+    unite(link->getSource()->getHandle().index,
+          link->getDestination()->getHandle().index);
+  }
+
+  m_componentsDirty = false;
+}
+
+uint32_t PowerGrid::findComponentRoot(const Object* structure) {
+  DCHECK(nodeFor(structure).structure == structure)
+      << "Structure is not in the grid.";
+
+  if (m_componentsDirty) {
+    rebuildComponents();
+  }
+
+  return findRoot(structure->getHandle().index);
+}
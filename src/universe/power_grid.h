@@ -0,0 +1,179 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#ifndef UNIVERSE_POWER_GRID_H_
+#define UNIVERSE_POWER_GRID_H_
+
+#include <cstdint>
+#include <functional>
+#include <unordered_set>
+#include <vector>
+
+#include <nucleus/macros.h>
+
+#include "utils/memory_pool.h"
+
+class Link;
+class Object;
+class Universe;
+
+// The network of links between structures.  Power relays link to every other
+// power relay in range and all other structures link to the closest power
+// relay in range.  The grid keeps a list of links for every structure, so
+// adding and removing structures only touches their own links, and tracks
+// which structures are connected with a union-find over the links.
+//
+// Power is shared by all the structures that are connected, so the grid also
+// keeps the power of every connected component.  It only changes when
+// structures or links do, so nothing has to be recalculated while the grid
+// stays the same.
+class PowerGrid {
+public:
+  // The furthest two structures can be apart and still be linked.
+  static const float kLinkRange;
+
+  explicit PowerGrid(Universe* universe);
+  ~PowerGrid();
+
+  // Return all the links in the grid.
+  const std::vector<Link*>& getLinks() const { return m_links; }
+
+  // Return the links of the given structure.
+  const std::vector<Link*>& getLinksFor(const Object* structure) const;
+
+  // Add a structure to the grid without linking it to anything.
+  void addStructure(Object* structure);
+
+  // Link a structure that was added to the grid to the structures around it.
+  // A power relay also picks up the structures in range that aren't linked to
+  // a power relay yet.
+  void linkStructure(Object* structure);
+
+  // Remove a structure and all its links from the grid.  Structures that were
+  // only linked through it are linked to the next closest power relay.  The
+  // structure must already be out of the universe's spatial index.
+  void removeStructure(Object* structure);
+
+  // Link two structures in the grid.  Returns null if they are already
+  // linked.
+  Link* addLink(Object* source, Object* destination);
+
+  // Returns true if the two structures are linked directly.
+  bool hasLink(const Object* left, const Object* right) const;
+
+  // Return an id for the group of structures that are connected to the given
+  // structure through links.  Connected structures have the same id.  Ids are
+  // only valid until the grid changes.
+  uint32_t getComponent(const Object* structure);
+
+  // Returns true if there is a path of links between the two structures.
+  bool areConnected(const Object* left, const Object* right);
+
+  // Return the total power of all the structures in the grid.
+  int32_t getTotalPower() const { return m_totalPower; }
+
+  // Return the power of all the structures connected to the given structure.
+  int32_t getComponentPower(const Object* structure);
+
+  // Returns true if the structures connected to the given structure make at
+  // least as much power as they use.
+  bool isPowered(const Object* structure);
+
+  // Find all the structures that are connected to structures that use more
+  // power than they make.
+  void findUnpoweredStructures(std::vector<Object*>* structuresOut);
+
+  // Remove all the structures and delete all the links.
+  void clear();
+
+private:
+  // A structure in the grid.  Nodes are indexed by the handle index of their
+  // structure.
+  struct Node {
+    Object* structure{nullptr};
+    std::vector<Link*> links;
+
+    // The union-find parent and rank of the node.
+    uint32_t parent{0};
+    uint32_t rank{0};
+
+    // The power the structure adds to the grid.
+    int32_t power{0};
+
+    // The power of all the nodes in the set.  Only valid for the root.
+    int32_t componentPower{0};
+  };
+
+  // Return the key that identifies the link between two structures, no matter
+  // which way around they are.
+  static uint64_t linkKeyFor(const Object* left, const Object* right);
+
+  // Return the node of a structure in the grid.
+  Node& nodeFor(const Object* structure);
+  const Node& nodeFor(const Object* structure) const;
+
+  // Link a structure that is not a power relay to the closest power relay in
+  // range, if there is one.
+  void linkToClosestRelay(Object* structure);
+
+  // Delete a link and remove it from the link list.  The nodes' link lists
+  // are not touched.
+  void deleteLink(Link* link);
+
+  // Return the root of the node's set, compressing the path along the way.
+  uint32_t findRoot(uint32_t index);
+
+  // Merge the sets of the two nodes and add up their power.
+  void unite(uint32_t left, uint32_t right);
+
+  // Rebuild all the sets and their power from the links.  Sets can't be
+  // split, so this is done lazily after a linked structure was removed.
+  void rebuildComponents();
+
+  // Return the root of the set the structure is in, rebuilding the sets first
+  // if needed.
+  uint32_t findComponentRoot(const Object* structure);
+
+  // The universe the structures live in.
+  Universe* m_universe;
+
+  // All the nodes, indexed by handle index.  Nodes without a structure are
+  // not in use.
+  std::vector<Node> m_nodes;
+
+  // All the links in the grid.  Links know their index in here, so they can
+  // be removed without searching.
+  std::vector<Link*> m_links;
+
+  // The keys of all the links, so that duplicates are found without searching.
+  // Structures are linked and unlinked while ticking, so the keys come from a
+  // pool.
+  std::unordered_set<uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                     PoolAllocator<uint64_t>>
+      m_linkKeys;
+
+  // Scratch space for the structures that lose their last link when a
+  // structure is removed.
+  std::vector<Object*> m_orphans;
+
+  // Whether a linked structure was removed since the sets were last built.
+  bool m_componentsDirty{false};
+
+  // The power of all the structures in the grid.
+  int32_t m_totalPower{0};
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(PowerGrid);
+};
+
+#endif  // UNIVERSE_POWER_GRID_H_
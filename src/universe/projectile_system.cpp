@@ -0,0 +1,423 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#include "universe/projectile_system.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <nucleus/logging.h>
+
+#include "universe/objects/projectiles/projectile.h"
+#include "universe/universe.h"
+
+// static
+const float ProjectileSystem::kHitRadius = 10.f;
+
+// static
+uint32_t ProjectileSystem::typeMaskFor(ObjectType objectType) {
+  return 1u << static_cast<uint32_t>(objectType);
+}
+
+// static
+uint32_t ProjectileSystem::typeMaskFor(
+    const std::set<ObjectType>& objectTypes) {
+  uint32_t typeMask = 0;
+  for (const auto& objectType : objectTypes) {
+    typeMask |= typeMaskFor(objectType);
+  }
+  return typeMask;
+}
+
+ProjectileSystem::ProjectileSystem() {
+}
+
+ProjectileSystem::~ProjectileSystem() {
+}
+
+void ProjectileSystem::add(Projectile* projectile, const sf::Vector2f& pos,
+                           const sf::Vector2f& velocity, float maxRange) {
+  projectile->m_systemIndex = m_projectiles.size();
+
+  m_projectiles.push_back(projectile);
+  m_posX.push_back(pos.x);
+  m_posY.push_back(pos.y);
+  m_velocityX.push_back(velocity.x);
+  m_velocityY.push_back(velocity.y);
+  m_originX.push_back(pos.x);
+  m_originY.push_back(pos.y);
+
+  // Don't let the square of a very large range overflow to infinity.
+  const float maxRangeSquared =
+      (maxRange < std::sqrt(std::numeric_limits<float>::max()))
+          ? maxRange * maxRange
+          : std::numeric_limits<float>::max();
+  m_maxRangeSquared.push_back(maxRangeSquared);
+  m_previousPosX.push_back(pos.x);
+  m_previousPosY.push_back(pos.y);
+  m_collisionTypes.push_back(0);
+}
+
+void ProjectileSystem::remove(Projectile* projectile) {
+  const size_t index = projectile->m_systemIndex;
+  if (index >= m_projectiles.size() || m_projectiles[index] != projectile) {
+    LOG(Error) << "Trying to remove projectile that is not in the system!";
+    return;
+  }
+
+  // Move the last projectile into the free spot.
+  const size_t last = m_projectiles.size() - 1;
+  if (index != last) {
+    m_projectiles[index] = m_projectiles[last];
+    m_projectiles[index]->m_systemIndex = index;
+    m_posX[index] = m_posX[last];
+    m_posY[index] = m_posY[last];
+    m_velocityX[index] = m_velocityX[last];
+    m_velocityY[index] = m_velocityY[last];
+    m_originX[index] = m_originX[last];
+    m_originY[index] = m_originY[last];
+    m_maxRangeSquared[index] = m_maxRangeSquared[last];
+    m_previousPosX[index] = m_previousPosX[last];
+    m_previousPosY[index] = m_previousPosY[last];
+    m_collisionTypes[index] = m_collisionTypes[last];
+  }
+
+  m_projectiles.pop_back();
+  m_posX.pop_back();
+  m_posY.pop_back();
+  m_velocityX.pop_back();
+  m_velocityY.pop_back();
+  m_originX.pop_back();
+  m_originY.pop_back();
+  m_maxRangeSquared.pop_back();
+  m_previousPosX.pop_back();
+  m_previousPosY.pop_back();
+  m_collisionTypes.pop_back();
+}
+
+void ProjectileSystem::setPos(Projectile* projectile, const sf::Vector2f& pos) {
+  // The projectile jumps to its new position, so it doesn't collide with
+  // anything on the way.
+  m_posX[projectile->m_systemIndex] = pos.x;
+  m_posY[projectile->m_systemIndex] = pos.y;
+  m_previousPosX[projectile->m_systemIndex] = pos.x;
+  m_previousPosY[projectile->m_systemIndex] = pos.y;
+}
+
+void ProjectileSystem::setVelocity(Projectile* projectile,
+                                   const sf::Vector2f& velocity) {
+  m_velocityX[projectile->m_systemIndex] = velocity.x;
+  m_velocityY[projectile->m_systemIndex] = velocity.y;
+}
+
+void ProjectileSystem::setCollisionTypes(Projectile* projectile,
+                                         uint32_t typeMask) {
+  m_collisionTypes[projectile->m_systemIndex] = typeMask;
+}
+
+void ProjectileSystem::tick(float adjustment,
+                            std::vector<Projectile*>* expiredOut) {
+  const size_t count = m_projectiles.size();
+  m_expired.resize(count);
+
+  float* posX = m_posX.data();
+  float* posY = m_posY.data();
+  const float* velocityX = m_velocityX.data();
+  const float* velocityY = m_velocityY.data();
+  const float* originX = m_originX.data();
+  const float* originY = m_originY.data();
+  const float* maxRangeSquared = m_maxRangeSquared.data();
+  uint8_t* expired = m_expired.data();
+
+  // Remember where the projectiles started, so that we can find out what
+  // they ran into on the way.
+  std::copy(m_posX.begin(), m_posX.end(), m_previousPosX.begin());
+  std::copy(m_posY.begin(), m_posY.end(), m_previousPosY.begin());
+
+  // Integrate and check the range in one branch free pass.
+  for (size_t i = 0; i < count; ++i) {
+    posX[i] += velocityX[i] * adjustment;
+    posY[i] += velocityY[i] * adjustment;
+
+    const float dx = posX[i] - originX[i];
+    const float dy = posY[i] - originY[i];
+    expired[i] = (dx * dx + dy * dy > maxRangeSquared[i]) ? 1 : 0;
+  }
+
+  // Write the new positions back to the objects.  The universe updates its
+  // spatial index for all of them at once afterwards.
+  for (size_t i = 0; i < count; ++i) {
+    m_projectiles[i]->m_pos = sf::Vector2f{posX[i], posY[i]};
+
+    if (expired[i]) {
+      expiredOut->push_back(m_projectiles[i]);
+    }
+  }
+}
+
+void ProjectileSystem::findCollisions(const Targets& targets,
+                                      std::vector<Collision>* collisionsOut) {
+  uint32_t typeMask = 0;
+  for (const auto& collisionTypes : m_collisionTypes) {
+    typeMask |= collisionTypes;
+  }
+  if (!typeMask) {
+    return;
+  }
+
+  // Gather the objects of all the types that any projectile can run into.
+  m_gatheredTargets.clear();
+  sf::Vector2f boundsMin{std::numeric_limits<float>::max(),
+                         std::numeric_limits<float>::max()};
+  sf::Vector2f boundsMax{std::numeric_limits<float>::lowest(),
+                         std::numeric_limits<float>::lowest()};
+  for (size_t type = 0; type < kObjectTypeCount; ++type) {
+    const uint32_t targetTypeMask =
+        typeMaskFor(static_cast<ObjectType>(type));
+    if (!(typeMask & targetTypeMask)) {
+      continue;
+    }
+
+    for (const auto& object : targets[type]) {
+      const sf::Vector2f& pos = object->getPos();
+      boundsMin.x = std::min(boundsMin.x, pos.x);
+      boundsMin.y = std::min(boundsMin.y, pos.y);
+      boundsMax.x = std::max(boundsMax.x, pos.x);
+      boundsMax.y = std::max(boundsMax.y, pos.y);
+      m_gatheredTargets.push_back(CollisionTarget{
+          pos, targetTypeMask,
+          static_cast<uint32_t>(m_gatheredTargets.size()), object});
+    }
+  }
+
+  if (m_gatheredTargets.empty()) {
+    return;
+  }
+
+  // Bucket the targets into a grid over their bounds with about one target
+  // per cell.  The buckets are filled in gather order, so the result doesn't
+  // depend on anything but the order of the targets.
+  const size_t cellsPerSide = std::max<size_t>(
+      1, static_cast<size_t>(std::sqrt(m_gatheredTargets.size())));
+  const float cellSize =
+      std::max(std::max(boundsMax.x - boundsMin.x, boundsMax.y - boundsMin.y) /
+                   cellsPerSide,
+               kHitRadius * 2.f);
+  const size_t cellsX =
+      static_cast<size_t>((boundsMax.x - boundsMin.x) / cellSize) + 1;
+  const size_t cellsY =
+      static_cast<size_t>((boundsMax.y - boundsMin.y) / cellSize) + 1;
+
+  auto cellX = [&boundsMin, cellSize, cellsX](float x) {
+    const float cell = std::max((x - boundsMin.x) / cellSize, 0.f);
+    return std::min(static_cast<size_t>(cell), cellsX - 1);
+  };
+  auto cellY = [&boundsMin, cellSize, cellsY](float y) {
+    const float cell = std::max((y - boundsMin.y) / cellSize, 0.f);
+    return std::min(static_cast<size_t>(cell), cellsY - 1);
+  };
+
+  m_targetCellStarts.assign(cellsX * cellsY + 1, 0);
+  for (const auto& target : m_gatheredTargets) {
+    ++m_targetCellStarts[cellY(target.pos.y) * cellsX + cellX(target.pos.x) +
+                         1];
+  }
+  for (size_t i = 1; i < m_targetCellStarts.size(); ++i) {
+    m_targetCellStarts[i] += m_targetCellStarts[i - 1];
+  }
+  m_targetCellFill.assign(std::begin(m_targetCellStarts),
+                          std::end(m_targetCellStarts) - 1);
+  m_targetsByCell.resize(m_gatheredTargets.size());
+  for (const auto& target : m_gatheredTargets) {
+    const size_t cell = cellY(target.pos.y) * cellsX + cellX(target.pos.x);
+    m_targetsByCell[m_targetCellFill[cell]++] = target;
+  }
+
+  // Sweep the path of every projectile over the cells it passed through and
+  // keep the target it reached first.
+  for (size_t i = 0; i < m_projectiles.size(); ++i) {
+    if (!m_collisionTypes[i]) {
+      continue;
+    }
+
+    const float minX = std::min(m_previousPosX[i], m_posX[i]) - kHitRadius;
+    const float maxX = std::max(m_previousPosX[i], m_posX[i]) + kHitRadius;
+    const float minY = std::min(m_previousPosY[i], m_posY[i]) - kHitRadius;
+    const float maxY = std::max(m_previousPosY[i], m_posY[i]) + kHitRadius;
+    if (maxX < boundsMin.x || minX > boundsMax.x || maxY < boundsMin.y ||
+        minY > boundsMax.y) {
+      continue;
+    }
+
+    CollisionTarget* hitTarget = nullptr;
+    float hitTime = std::numeric_limits<float>::max();
+
+    const size_t lastCellX = cellX(maxX);
+    const size_t lastCellY = cellY(maxY);
+    for (size_t y = cellY(minY); y <= lastCellY; ++y) {
+      for (size_t x = cellX(minX); x <= lastCellX; ++x) {
+        const size_t cell = y * cellsX + x;
+        for (uint32_t t = m_targetCellStarts[cell];
+             t < m_targetCellStarts[cell + 1]; ++t) {
+          CollisionTarget& target = m_targetsByCell[t];
+          if (!(m_collisionTypes[i] & target.typeMask)) {
+            continue;
+          }
+
+          // Targets that are hit at the same time are decided by the order
+          // they were gathered in.
+          float time;
+          if (pathHits(i, target.pos, &time) &&
+              (time < hitTime ||
+               (time == hitTime && target.order < hitTarget->order))) {
+            hitTime = time;
+            hitTarget = &target;
+          }
+        }
+      }
+    }
+
+    if (hitTarget) {
+      collisionsOut->push_back(Collision{m_projectiles[i], hitTarget->object});
+    }
+  }
+}
+
+void ProjectileSystem::hashState(StateHash* hash) const {
+  hash->add(m_projectiles.size());
+  for (size_t i = 0; i < m_projectiles.size(); ++i) {
+    const ObjectHandle& handle = m_projectiles[i]->getHandle();
+    hash->add(handle.index);
+    hash->add(handle.generation);
+    hash->add(m_posX[i]);
+    hash->add(m_posY[i]);
+    hash->add(m_velocityX[i]);
+    hash->add(m_velocityY[i]);
+    hash->add(m_originX[i]);
+    hash->add(m_originY[i]);
+    hash->add(m_maxRangeSquared[i]);
+    hash->add(m_collisionTypes[i]);
+  }
+}
+
+void ProjectileSystem::saveState(BinaryWriter* writer) const {
+  writer->write(static_cast<uint32_t>(m_projectiles.size()));
+  for (size_t i = 0; i < m_projectiles.size(); ++i) {
+    const ObjectHandle& handle = m_projectiles[i]->getHandle();
+    writer->write(handle.index);
+    writer->write(handle.generation);
+    writer->write(m_posX[i]);
+    writer->write(m_posY[i]);
+    writer->write(m_velocityX[i]);
+    writer->write(m_velocityY[i]);
+    writer->write(m_originX[i]);
+    writer->write(m_originY[i]);
+    writer->write(m_maxRangeSquared[i]);
+    writer->write(m_collisionTypes[i]);
+  }
+}
+
+bool ProjectileSystem::loadState(BinaryReader* reader,
+                                 const Universe& universe) {
+  size_t count = 0;
+  if (!reader->readCount(m_projectiles.size(), &count) ||
+      count != m_projectiles.size()) {
+    reader->fail();
+    return false;
+  }
+
+  // Every projectile must show up exactly once, so keep track of the ones we
+  // have seen.
+  std::vector<uint8_t> seen(count, 0);
+
+  std::vector<Projectile*> projectiles(count, nullptr);
+  for (size_t i = 0; i < count; ++i) {
+    ObjectHandle handle;
+    reader->read(&handle.index);
+    reader->read(&handle.generation);
+    reader->read(&m_posX[i]);
+    reader->read(&m_posY[i]);
+    reader->read(&m_velocityX[i]);
+    reader->read(&m_velocityY[i]);
+    reader->read(&m_originX[i]);
+    reader->read(&m_originY[i]);
+    reader->read(&m_maxRangeSquared[i]);
+    reader->read(&m_collisionTypes[i]);
+    if (!reader->isOk()) {
+      return false;
+    }
+    m_previousPosX[i] = m_posX[i];
+    m_previousPosY[i] = m_posY[i];
+
+    Object* object = universe.resolve(handle);
+    if (!object || !Object::isProjectile(object)) {
+      reader->fail();
+      return false;
+    }
+
+    Projectile* projectile = static_cast<Projectile*>(object);
+    if (projectile->m_systemIndex >= count ||
+        m_projectiles[projectile->m_systemIndex] != projectile ||
+        seen[projectile->m_systemIndex]) {
+      reader->fail();
+      return false;
+    }
+    seen[projectile->m_systemIndex] = 1;
+
+    projectiles[i] = projectile;
+  }
+
+  m_projectiles.swap(projectiles);
+  for (size_t i = 0; i < count; ++i) {
+    m_projectiles[i]->m_systemIndex = i;
+  }
+
+  return true;
+}
+
+bool ProjectileSystem::pathHits(size_t index, const sf::Vector2f& pos,
+                                float* timeOut) const {
+  // Solve |start + direction * time - pos| = kHitRadius for the first time in
+  // [0, 1].
+  const float startX = m_previousPosX[index] - pos.x;
+  const float startY = m_previousPosY[index] - pos.y;
+  const float c = startX * startX + startY * startY - kHitRadius * kHitRadius;
+  if (c <= 0.f) {
+    // We started out within range.
+    *timeOut = 0.f;
+    return true;
+  }
+
+  const float directionX = m_posX[index] - m_previousPosX[index];
+  const float directionY = m_posY[index] - m_previousPosY[index];
+  const float a = directionX * directionX + directionY * directionY;
+  if (a == 0.f) {
+    return false;
+  }
+
+  const float b = 2.f * (startX * directionX + startY * directionY);
+  const float discriminant = b * b - 4.f * a * c;
+  if (discriminant < 0.f) {
+    return false;
+  }
+
+  const float time = (-b - std::sqrt(discriminant)) / (2.f * a);
+  if (time < 0.f || time > 1.f) {
+    return false;
+  }
+
+  *timeOut = time;
+  return true;
+}
@@ -0,0 +1,171 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#ifndef UNIVERSE_PROJECTILE_SYSTEM_H_
+#define UNIVERSE_PROJECTILE_SYSTEM_H_
+
+#include <array>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+#include <nucleus/macros.h>
+#include <SFML/System/Vector2.hpp>
+
+#include "universe/objects/object.h"
+#include "utils/binary_stream.h"
+
+class Projectile;
+class Universe;
+
+// Keeps the motion state of every projectile in the universe in flat arrays
+// (structure of arrays) so that all of them can be moved in one tight loop
+// that the compiler can vectorize.  Projectiles are still objects in the
+// universe, but they don't move themselves; the system writes their new
+// positions back to them after each tick.
+//
+// The system also finds what the projectiles ran into.  The objects that can be
+// hit are bucketed into a grid once per tick and the path every projectile
+// moved along is swept through it in a single pass, so fast projectiles can't
+// skip over their targets and no projectile has to query the universe on its
+// own.
+class ProjectileSystem {
+public:
+  // A projectile that ran into an object.
+  struct Collision {
+    Projectile* projectile;
+    Object* object;
+  };
+
+  // The objects projectiles can run into, bucketed by type.
+  using Targets = std::array<std::vector<Object*>, kObjectTypeCount>;
+
+  // Projectiles hit objects whose position comes within this distance of the
+  // path they moved along.
+  static const float kHitRadius;
+
+  // Return a mask with the bits for the given object types set.
+  static uint32_t typeMaskFor(ObjectType objectType);
+  static uint32_t typeMaskFor(const std::set<ObjectType>& objectTypes);
+
+  ProjectileSystem();
+  ~ProjectileSystem();
+
+  // Return the number of projectiles in the system.
+  size_t getProjectileCount() const { return m_projectiles.size(); }
+
+  // Add a projectile at pos, travelling with the given velocity (units per
+  // tick).  Once it is further than maxRange from pos, it is expired.
+  void add(Projectile* projectile, const sf::Vector2f& pos,
+           const sf::Vector2f& velocity, float maxRange);
+
+  // Remove a projectile from the system.
+  void remove(Projectile* projectile);
+
+  // Override the position of a projectile.
+  void setPos(Projectile* projectile, const sf::Vector2f& pos);
+
+  // Change the velocity of a projectile.  Like everything else here, this
+  // must not be called from objects being ticked on worker threads; they go
+  // through Universe::setProjectileVelocity instead.
+  void setVelocity(Projectile* projectile, const sf::Vector2f& velocity);
+
+  // Set the types of objects a projectile runs into with a mask from
+  // typeMaskFor.  Projectiles with a mask of 0 don't run into anything.
+  // Objects being ticked go through Universe::setProjectileCollisionTypes.
+  void setCollisionTypes(Projectile* projectile, uint32_t typeMask);
+
+  // Move all the projectiles by their velocity scaled by adjustment and
+  // update the positions of the projectile objects.  The spatial indices are
+  // not told about the moves, so the caller has to update them.  Projectiles
+  // that went out of range are added to expiredOut.
+  void tick(float adjustment, std::vector<Projectile*>* expiredOut);
+
+  // Find the first object that every projectile ran into along the path it
+  // moved during the last tick.  Collisions are added in the order the
+  // projectiles are in the system.
+  void findCollisions(const Targets& targets,
+                      std::vector<Collision>* collisionsOut);
+
+  // Add the motion of every projectile to the hash, in the order they are
+  // moved in.
+  void hashState(StateHash* hash) const;
+
+  // Write the motion of every projectile to a snapshot, in the order they are
+  // moved in.
+  void saveState(BinaryWriter* writer) const;
+
+  // Read the motion written by saveState.  The projectiles are looked up by
+  // their handles in the universe and must already be in the system; they are
+  // put back in the order they were saved in.  Returns false if the data
+  // doesn't match the projectiles in the system.
+  bool loadState(BinaryReader* reader, const Universe& universe);
+
+private:
+  // An object that projectiles can hit, while finding collisions.
+  struct CollisionTarget {
+    sf::Vector2f pos;
+    uint32_t typeMask;
+
+    // The order the target was gathered in, which breaks ties between targets
+    // that are hit at the same time.
+    uint32_t order;
+
+    Object* object;
+  };
+
+  // Returns true if the path of the projectile at index comes within the hit
+  // radius of pos and sets timeOut to how far along the path that happens.
+  bool pathHits(size_t index, const sf::Vector2f& pos, float* timeOut) const;
+
+  // The projectile objects.  All the arrays below are indexed the same way.
+  std::vector<Projectile*> m_projectiles;
+
+  // Current positions.
+  std::vector<float> m_posX;
+  std::vector<float> m_posY;
+
+  // Velocities in units per tick.
+  std::vector<float> m_velocityX;
+  std::vector<float> m_velocityY;
+
+  // Positions where the projectiles started.
+  std::vector<float> m_originX;
+  std::vector<float> m_originY;
+
+  // The squared range of each projectile.
+  std::vector<float> m_maxRangeSquared;
+
+  // Positions at the start of the last tick.
+  std::vector<float> m_previousPosX;
+  std::vector<float> m_previousPosY;
+
+  // The types of objects each projectile runs into.
+  std::vector<uint32_t> m_collisionTypes;
+
+  // Scratch space for finding collisions.  The gathered targets are bucketed
+  // into a grid stored as the targets sorted by cell and the index where each
+  // cell starts.
+  std::vector<CollisionTarget> m_gatheredTargets;
+  std::vector<CollisionTarget> m_targetsByCell;
+  std::vector<uint32_t> m_targetCellStarts;
+  std::vector<uint32_t> m_targetCellFill;
+
+  // Scratch space to mark expired projectiles during a tick.
+  std::vector<uint8_t> m_expired;
+
+  DISALLOW_COPY_AND_ASSIGN(ProjectileSystem);
+};
+
+#endif  // UNIVERSE_PROJECTILE_SYSTEM_H_
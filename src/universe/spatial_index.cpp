@@ -0,0 +1,412 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#include "universe/spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <nucleus/logging.h>
+
+namespace {
+
+// Small indices keep this many empty cells around before they are dropped,
+// so that they aren't swept all the time.
+const size_t kMinEmptyCells = 64;
+
+}  // namespace
+
+const float SpatialIndex::kCellSize = 250.f;
+
+// static
+float SpatialIndex::extentOf(const sf::FloatRect& localBounds) {
+  // We use the distance to the corners of the bounds, so that the extent still
+  // holds when objects like asteroids rotate after they were inserted.
+  const float right = localBounds.left + localBounds.width;
+  const float bottom = localBounds.top + localBounds.height;
+  const float reachSquared =
+      std::max(localBounds.left * localBounds.left, right * right) +
+      std::max(localBounds.top * localBounds.top, bottom * bottom);
+  return std::sqrt(reachSquared);
+}
+
+SpatialIndex::SpatialIndex() {
+}
+
+SpatialIndex::~SpatialIndex() {
+}
+
+void SpatialIndex::setFixedExtent(float extent) {
+  m_fixedExtent = extent;
+  m_maxExtent = std::max(m_maxExtent, extent);
+}
+
+void SpatialIndex::insert(Object* object) {
+  DCHECK(!object->m_isIndexed) << "Object is already in the index.";
+
+  const sf::Vector2f& pos = object->getPos();
+  addToCell(object, cellCoordFor(pos.x), cellCoordFor(pos.y));
+
+  object->m_isIndexed = true;
+  ++m_objectCount;
+
+  if (m_fixedExtent > 0.f) {
+    return;
+  }
+
+  // Keep track of how far the bounds of objects reach from their positions.
+  sf::FloatRect bounds = object->getBounds();
+  m_maxExtent = std::max(
+      m_maxExtent, extentOf(sf::FloatRect{bounds.left - pos.x,
+                                          bounds.top - pos.y, bounds.width,
+                                          bounds.height}));
+}
+
+void SpatialIndex::remove(Object* object) {
+  if (!object->m_isIndexed) {
+    return;
+  }
+
+  removeFromCell(object, object->m_spatialCell);
+
+  object->m_isIndexed = false;
+  --m_objectCount;
+}
+
+void SpatialIndex::update(Object* object) {
+  if (!object->m_isIndexed) {
+    return;
+  }
+
+  // Most of the time an object moves within the same cell, so there is nothing
+  // to do.
+  const sf::Vector2f& pos = object->getPos();
+  const int32_t x = cellCoordFor(pos.x);
+  const int32_t y = cellCoordFor(pos.y);
+  if (keyFor(x, y) == object->m_spatialCell) {
+    return;
+  }
+
+  // Moving doesn't change how far the object reaches, so it only changes
+  // cells.
+  removeFromCell(object, object->m_spatialCell);
+  addToCell(object, x, y);
+}
+
+void SpatialIndex::update(const std::vector<Object*>& objects) {
+  for (const auto& object : objects) {
+    update(object);
+  }
+}
+
+void SpatialIndex::clear() {
+  for (auto& cell : m_cells) {
+    for (Object* object = cell.second.first; object;
+         object = object->m_nextInCell) {
+      object->m_isIndexed = false;
+    }
+  }
+
+  m_cells.clear();
+  m_objectCount = 0;
+  m_occupiedCellCount = 0;
+  m_minCellX = std::numeric_limits<int32_t>::max();
+  m_minCellY = std::numeric_limits<int32_t>::max();
+  m_maxCellX = std::numeric_limits<int32_t>::min();
+  m_maxCellY = std::numeric_limits<int32_t>::min();
+  m_maxExtent = m_fixedExtent;
+}
+
+void SpatialIndex::dropEmptyCells() {
+  // Only sweep once the empty cells outnumber the others, so the cost of the
+  // sweep is spread over all the cells that were emptied since the last one.
+  const size_t emptyCellCount = m_cells.size() - m_occupiedCellCount;
+  if (emptyCellCount <= std::max(kMinEmptyCells, m_occupiedCellCount)) {
+    return;
+  }
+
+  m_minCellX = std::numeric_limits<int32_t>::max();
+  m_minCellY = std::numeric_limits<int32_t>::max();
+  m_maxCellX = std::numeric_limits<int32_t>::min();
+  m_maxCellY = std::numeric_limits<int32_t>::min();
+
+  for (auto it = std::begin(m_cells); it != std::end(m_cells);) {
+    if (!it->second.first) {
+      it = m_cells.erase(it);
+      continue;
+    }
+
+    int32_t x = 0;
+    int32_t y = 0;
+    coordsFor(it->first, &x, &y);
+    m_minCellX = std::min(m_minCellX, x);
+    m_minCellY = std::min(m_minCellY, y);
+    m_maxCellX = std::max(m_maxCellX, x);
+    m_maxCellY = std::max(m_maxCellY, y);
+    ++it;
+  }
+}
+
+void SpatialIndex::getObjects(std::vector<Object*>* objectsOut) const {
+  DCHECK(objectsOut);
+
+  // The order the map keeps its cells in depends on every cell it ever had,
+  // so go through the cells in key order to get the same order for two
+  // indices with the same objects in them.
+  std::vector<std::pair<CellKey, const Cell*>> cells;
+  cells.reserve(m_cells.size());
+  for (const auto& cell : m_cells) {
+    if (cell.second.first) {
+      cells.emplace_back(cell.first, &cell.second);
+    }
+  }
+  std::sort(std::begin(cells), std::end(cells));
+
+  for (const auto& cell : cells) {
+    for (Object* object = cell.second->first; object;
+         object = object->m_nextInCell) {
+      objectsOut->emplace_back(object);
+    }
+  }
+}
+
+void SpatialIndex::findObjectsInRadius(const sf::Vector2f& origin,
+                                       float radius,
+                                       std::vector<Object*>* objectsOut) const {
+  DCHECK(objectsOut);
+
+  if (!m_objectCount) {
+    return;
+  }
+
+  // Only visit the cells that overlap the bounding box of the circle and that
+  // could possibly contain objects.
+  const int32_t minX = std::max(m_minCellX, cellCoordFor(origin.x - radius));
+  const int32_t minY = std::max(m_minCellY, cellCoordFor(origin.y - radius));
+  const int32_t maxX = std::min(m_maxCellX, cellCoordFor(origin.x + radius));
+  const int32_t maxY = std::min(m_maxCellY, cellCoordFor(origin.y + radius));
+
+  for (int32_t y = minY; y <= maxY; ++y) {
+    for (int32_t x = minX; x <= maxX; ++x) {
+      const Cell* cell = findCell(x, y);
+      if (!cell) {
+        continue;
+      }
+
+      for (Object* object = cell->first; object;
+           object = object->m_nextInCell) {
+        if (object->calculateDistanceFrom(origin) <= radius) {
+          objectsOut->emplace_back(object);
+        }
+      }
+    }
+  }
+}
+
+void SpatialIndex::findObjectsInRect(const sf::FloatRect& rect,
+                                     std::vector<Object*>* objectsOut) const {
+  DCHECK(objectsOut);
+
+  if (!m_objectCount) {
+    return;
+  }
+
+  const int32_t minX = std::max(m_minCellX, cellCoordFor(rect.left));
+  const int32_t minY = std::max(m_minCellY, cellCoordFor(rect.top));
+  const int32_t maxX =
+      std::min(m_maxCellX, cellCoordFor(rect.left + rect.width));
+  const int32_t maxY =
+      std::min(m_maxCellY, cellCoordFor(rect.top + rect.height));
+
+  for (int32_t y = minY; y <= maxY; ++y) {
+    for (int32_t x = minX; x <= maxX; ++x) {
+      const Cell* cell = findCell(x, y);
+      if (!cell) {
+        continue;
+      }
+
+      // Cells completely inside the rect don't need to check each object.
+      const float cellLeft = static_cast<float>(x) * kCellSize;
+      const float cellTop = static_cast<float>(y) * kCellSize;
+      const bool insideRect = cellLeft >= rect.left && cellTop >= rect.top &&
+                              cellLeft + kCellSize <= rect.left + rect.width &&
+                              cellTop + kCellSize <= rect.top + rect.height;
+
+      for (Object* object = cell->first; object;
+           object = object->m_nextInCell) {
+        if (insideRect || rect.contains(object->getPos())) {
+          objectsOut->emplace_back(object);
+        }
+      }
+    }
+  }
+}
+
+Object* SpatialIndex::findClosestObject(const sf::Vector2f& pos,
+                                       float maxRange) const {
+  if (!m_objectCount) {
+    return nullptr;
+  }
+
+  const int32_t centerX = cellCoordFor(pos.x);
+  const int32_t centerY = cellCoordFor(pos.y);
+
+  // We search in rings of cells around the center cell.  There is no need to
+  // search further than the furthest cell we have.
+  int32_t maxRing = std::max(
+      std::max(std::abs(centerX - m_minCellX), std::abs(m_maxCellX - centerX)),
+      std::max(std::abs(centerY - m_minCellY), std::abs(m_maxCellY - centerY)));
+
+  // Or further than the maximum range.
+  if (maxRange / kCellSize < static_cast<float>(maxRing)) {
+    maxRing = static_cast<int32_t>(std::ceil(maxRange / kCellSize));
+  }
+
+  float bestDistance{std::numeric_limits<float>::max()};
+  Object* bestObject{nullptr};
+
+  auto visitCell = [&](int32_t x, int32_t y) {
+    if (x < m_minCellX || x > m_maxCellX || y < m_minCellY || y > m_maxCellY) {
+      return;
+    }
+
+    const Cell* cell = findCell(x, y);
+    if (!cell) {
+      return;
+    }
+
+    for (Object* object = cell->first; object; object = object->m_nextInCell) {
+      float distance = object->calculateDistanceFrom(pos);
+      if (distance > maxRange) {
+        continue;
+      }
+
+      if (distance < bestDistance) {
+        bestDistance = distance;
+        bestObject = object;
+      }
+    }
+  };
+
+  for (int32_t ring = 0; ring <= maxRing; ++ring) {
+    // Every object in this ring is at least (ring - 1) cells away from pos, so
+    // if we already found something closer than that, we're done.
+    if (bestObject && static_cast<float>(ring - 1) * kCellSize > bestDistance) {
+      break;
+    }
+
+    if (ring == 0) {
+      visitCell(centerX, centerY);
+      continue;
+    }
+
+    // Top and bottom rows of the ring.
+    for (int32_t x = centerX - ring; x <= centerX + ring; ++x) {
+      visitCell(x, centerY - ring);
+      visitCell(x, centerY + ring);
+    }
+
+    // Left and right columns of the ring, excluding the corners.
+    for (int32_t y = centerY - ring + 1; y <= centerY + ring - 1; ++y) {
+      visitCell(centerX - ring, y);
+      visitCell(centerX + ring, y);
+    }
+  }
+
+  return bestObject;
+}
+
+// static
+int32_t SpatialIndex::cellCoordFor(float value) {
+  return static_cast<int32_t>(std::floor(value / kCellSize));
+}
+
+// static
+SpatialIndex::CellKey SpatialIndex::keyFor(int32_t x, int32_t y) {
+  return (static_cast<CellKey>(static_cast<uint32_t>(x)) << 32) |
+         static_cast<CellKey>(static_cast<uint32_t>(y));
+}
+
+// static
+SpatialIndex::CellKey SpatialIndex::keyFor(const sf::Vector2f& pos) {
+  return keyFor(cellCoordFor(pos.x), cellCoordFor(pos.y));
+}
+
+// static
+void SpatialIndex::coordsFor(CellKey key, int32_t* xOut, int32_t* yOut) {
+  *xOut = static_cast<int32_t>(static_cast<uint32_t>(key >> 32));
+  *yOut = static_cast<int32_t>(static_cast<uint32_t>(key));
+}
+
+const SpatialIndex::Cell* SpatialIndex::findCell(int32_t x, int32_t y) const {
+  auto it = m_cells.find(keyFor(x, y));
+  if (it == std::end(m_cells)) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+void SpatialIndex::addToCell(Object* object, int32_t x, int32_t y) {
+  const CellKey key = keyFor(x, y);
+  Cell& cell = m_cells[key];
+
+  // Link the object in at the end of the cell.
+  object->m_previousInCell = cell.last;
+  object->m_nextInCell = nullptr;
+  if (cell.last) {
+    cell.last->m_nextInCell = object;
+  } else {
+    cell.first = object;
+    ++m_occupiedCellCount;
+  }
+  cell.last = object;
+
+  object->m_spatialCell = key;
+
+  // Grow the extents of the index to include the cell.
+  m_minCellX = std::min(m_minCellX, x);
+  m_minCellY = std::min(m_minCellY, y);
+  m_maxCellX = std::max(m_maxCellX, x);
+  m_maxCellY = std::max(m_maxCellY, y);
+}
+
+void SpatialIndex::removeFromCell(Object* object, CellKey key) {
+  auto cellIt = m_cells.find(key);
+  if (cellIt == std::end(m_cells)) {
+    LOG(Error) << "Object is not in the cell it was filed under!";
+    return;
+  }
+
+  // Unlink the object, which leaves the rest of the cell in order.  Empty
+  // cells are kept until dropEmptyCells, so that objects moving back into
+  // them don't have to create a new one.
+  Cell& cell = cellIt->second;
+  if (object->m_previousInCell) {
+    object->m_previousInCell->m_nextInCell = object->m_nextInCell;
+  } else {
+    cell.first = object->m_nextInCell;
+  }
+  if (object->m_nextInCell) {
+    object->m_nextInCell->m_previousInCell = object->m_previousInCell;
+  } else {
+    cell.last = object->m_previousInCell;
+  }
+
+  object->m_previousInCell = nullptr;
+  object->m_nextInCell = nullptr;
+
+  if (!cell.first) {
+    --m_occupiedCellCount;
+  }
+}
@@ -0,0 +1,165 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#ifndef UNIVERSE_SPATIAL_INDEX_H_
+#define UNIVERSE_SPATIAL_INDEX_H_
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include <nucleus/macros.h>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include "universe/objects/object.h"
+#include "utils/memory_pool.h"
+
+// A uniform grid that files objects into square cells by their position, so
+// that radius and closest object queries only have to look at the cells near
+// the query position instead of at every object in the universe.  The
+// universe keeps one index per object type, so the index itself doesn't care
+// about types.
+class SpatialIndex {
+public:
+  // The size of a single cell in universe units.  Queries range from 10 units
+  // (projectile collisions) to 2500 units (turret range), so this keeps the
+  // small, frequent queries down to one or two cells while the large ones
+  // still only touch a few hundred.
+  static const float kCellSize;
+
+  // Return how far bounds, given relative to an object's position, reach from
+  // the position in any direction, however the object is rotated.
+  static float extentOf(const sf::FloatRect& localBounds);
+
+  SpatialIndex();
+  ~SpatialIndex();
+
+  // Return the number of objects in the index.
+  size_t getObjectCount() const { return m_objectCount; }
+
+  // Return the furthest any object's bounds reached from its position when it
+  // was inserted, in any direction.  Objects are filed by position only, so
+  // area queries have to grow by this much to find every object whose bounds
+  // overlap the area, even after the object rotated.
+  float getMaxExtent() const { return m_maxExtent; }
+
+  // Use the given extent for every object in the index instead of measuring
+  // the bounds of each object as it is inserted.  Meant for types whose
+  // objects all have the same shape and come and go all the time.
+  void setFixedExtent(float extent);
+
+  // Add an object to the index at its current position.
+  void insert(Object* object);
+
+  // Remove an object from the index.
+  void remove(Object* object);
+
+  // Move the object to the correct cell if its position changed.  Objects
+  // that are not in the index are ignored.
+  void update(Object* object);
+
+  // Update a whole batch of objects that were moved together, like all the
+  // projectiles after the projectile system moved them.
+  void update(const std::vector<Object*>& objects);
+
+  // Remove all the objects from the index.
+  void clear();
+
+  // Drop the empty cells once there are more of them than cells with objects,
+  // and shrink the range of cells that searches look at to the cells that are
+  // left.  Cheap enough to call every tick.
+  void dropEmptyCells();
+
+  // Return all the objects in the index.  Inserting them into an empty index
+  // in this order files every cell's objects in the same order as here, which
+  // keeps the order of query results the same.
+  void getObjects(std::vector<Object*>* objectsOut) const;
+
+  // Find all the objects that are within radius of the origin.
+  void findObjectsInRadius(const sf::Vector2f& origin, float radius,
+                           std::vector<Object*>* objectsOut) const;
+
+  // Find all the objects whose position is inside rect.
+  void findObjectsInRect(const sf::FloatRect& rect,
+                         std::vector<Object*>* objectsOut) const;
+
+  // Find the closest object to pos that is within maxRange.
+  Object* findClosestObject(const sf::Vector2f& pos, float maxRange) const;
+
+private:
+  using CellKey = uint64_t;
+
+  // The objects in a cell are linked together through the objects themselves,
+  // in the order they were filed, so moving between cells never allocates.
+  struct Cell {
+    Object* first{nullptr};
+    Object* last{nullptr};
+  };
+
+  // Return the cell coordinate for the given universe coordinate.
+  static int32_t cellCoordFor(float value);
+
+  // Return the key for the cell at the given cell coordinates.
+  static CellKey keyFor(int32_t x, int32_t y);
+
+  // Return the key for the cell that contains the given position.
+  static CellKey keyFor(const sf::Vector2f& pos);
+
+  // Return the cell coordinates for the given key.
+  static void coordsFor(CellKey key, int32_t* xOut, int32_t* yOut);
+
+  // Return the cell at the given cell coordinates or null if it was never used.
+  const Cell* findCell(int32_t x, int32_t y) const;
+
+  // File the object in the cell at the given cell coordinates.
+  void addToCell(Object* object, int32_t x, int32_t y);
+
+  // Remove the object from the cell with the given key.
+  void removeFromCell(Object* object, CellKey key);
+
+  // The cells that had objects in them since dropEmptyCells last dropped the
+  // empty ones.  Empty cells are kept until then, because objects keep moving
+  // in and out of the same cells; dropping them right away made fast moving
+  // projectiles create and drop cells all the time.  Cells come from a pool,
+  // so cells that are dropped are reused by the next index that needs one.
+  std::unordered_map<CellKey, Cell, std::hash<CellKey>, std::equal_to<CellKey>,
+                     PoolAllocator<std::pair<const CellKey, Cell>>>
+      m_cells;
+
+  // The total number of objects in all the cells.
+  size_t m_objectCount{0};
+
+  // The number of cells that have objects in them.
+  size_t m_occupiedCellCount{0};
+
+  // The range of cell coordinates of all the cells, empty or not.  Searches
+  // use this to know when to stop.
+  int32_t m_minCellX{std::numeric_limits<int32_t>::max()};
+  int32_t m_minCellY{std::numeric_limits<int32_t>::max()};
+  int32_t m_maxCellX{std::numeric_limits<int32_t>::min()};
+  int32_t m_maxCellY{std::numeric_limits<int32_t>::min()};
+
+  // The furthest any object's bounds reached from its position.
+  float m_maxExtent{0.f};
+
+  // The extent set with setFixedExtent, or 0 if objects are measured.
+  float m_fixedExtent{0.f};
+
+  DISALLOW_COPY_AND_ASSIGN(SpatialIndex);
+};
+
+#endif  // UNIVERSE_SPATIAL_INDEX_H_
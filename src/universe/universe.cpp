@@ -18,21 +18,72 @@
 
 #include <cstdlib>
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <memory>
+#include <utility>
 
 #include <nucleus/logging.h>
 #include <SFML/Graphics/RectangleShape.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 
+#include "universe/command_log.h"
 #include "universe/link.h"
 #include "universe/objects/asteroid.h"
+#include "universe/objects/projectiles/bullet.h"
+#include "universe/objects/projectiles/missile.h"
+#include "universe/objects/projectiles/projectile.h"
 #include "universe/objects/structures/command_center.h"
+#include "universe/objects/structures/miner.h"
 #include "universe/objects/structures/power_relay.h"
+#include "universe/objects/structures/turret.h"
+#include "universe/objects/units/enemy_ship.h"
 #include "utils/math.h"
 
-Universe::Universe(ResourceManager* resourceManager)
-  : m_resourceManager(resourceManager) {
+namespace {
+
+// The number of objects ticked together with one command buffer.  Chunks are
+// what gets spread over the threads, so they have to be small enough to
+// balance the work, but big enough that claiming one doesn't cost more than
+// ticking it.
+const size_t kObjectsPerTickChunk = 64;
+
+// The command buffer of the chunk the current thread is ticking, or null if
+// the thread isn't ticking objects.
+thread_local CommandBuffer* s_commandBuffer = nullptr;
+
+// Every snapshot starts with this ("SGSS" in little-endian byte order) and the
+// version of the format.  Bump the version whenever the snapshot contents
+// change, including the state that objects save.
+const uint32_t kSnapshotMagic = 0x53534753;
+const uint32_t kSnapshotVersion = 3;
+
+// The number of watchers and watched objects every new slot has room for.
+const size_t kHandlesPerSlot = 4;
+
+// Remove the handle from the list if it is in there.  The order of the list is
+// not kept.
+void eraseHandle(std::vector<ObjectHandle>* handles,
+                 const ObjectHandle& handle) {
+  auto it = std::find(std::begin(*handles), std::end(*handles), handle);
+  if (it != std::end(*handles)) {
+    *it = handles->back();
+    handles->pop_back();
+  }
+}
+
+}  // namespace
+
+Universe::Universe(ResourceManager* resourceManager, uint64_t seed)
+  : m_resourceManager(resourceManager), m_random(seed),
+    m_threadPool(std::make_unique<ThreadPool>(1)), m_powerGrid(this) {
+  // Projectiles come and go all the time and all have the same shape, so
+  // their indices don't measure every one that is inserted.
+  spatialIndexFor(ObjectType::Bullet)
+      .setFixedExtent(SpatialIndex::extentOf(Bullet::kShape));
+  spatialIndexFor(ObjectType::Missile)
+      .setFixedExtent(SpatialIndex::extentOf(Missile::kShape));
+
   // Create a dummy universe.
 
   addObject(std::make_unique<CommandCenter>(this, sf::Vector2f{0.f, 0.f}));
@@ -46,45 +97,327 @@ Universe::~Universe() {
   m_inDestructor = true;
 
   // Delete all the objects we own.
-  for (auto& object : m_objects) {
-    delete object;
+  removeAllObjects();
+}
+
+Random* Universe::getRandom() {
+  DCHECK(!s_commandBuffer) << "Random numbers can't be used while ticking.";
+
+  return &m_random;
+}
+
+uint64_t Universe::calculateStateHash() const {
+  // Covers everything saveSnapshot writes, so that a snapshot that doesn't
+  // restore some of it shows up as a different hash.
+  StateHash hash;
+  hash.add(m_tickCount);
+  hash.add(m_random.getState());
+  hash.add(getPower());
+  hash.add(m_totalMinerals);
+
+  hash.add(m_slots.size());
+  for (const auto& slot : m_slots) {
+    hash.add(slot.generation);
+  }
+  hash.add(m_freeSlots.size());
+  for (const auto& index : m_freeSlots) {
+    hash.add(index);
   }
+
+  for (const auto& bucket : m_objects) {
+    hash.add(bucket.size());
+    for (const auto& object : bucket) {
+      object->hashState(&hash);
+    }
+  }
+
+  for (const auto& slot : m_slots) {
+    hash.add(slot.watchers.size());
+    for (const auto& watcher : slot.watchers) {
+      hash.add(watcher.index);
+      hash.add(watcher.generation);
+    }
+  }
+
+  std::vector<Object*> indexedObjects;
+  for (const auto& spatialIndex : m_spatialIndices) {
+    indexedObjects.clear();
+    spatialIndex.getObjects(&indexedObjects);
+    hash.add(indexedObjects.size());
+    for (const auto& object : indexedObjects) {
+      hash.add(object->getHandle().index);
+    }
+  }
+
+  const std::vector<Link*>& links = m_powerGrid.getLinks();
+  hash.add(links.size());
+  for (const auto& link : links) {
+    hash.add(link->getSource()->getHandle().index);
+    hash.add(link->getDestination()->getHandle().index);
+  }
+
+  m_projectileSystem.hashState(&hash);
+
+  return hash.get();
+}
+
+bool Universe::saveSnapshot(std::ostream* stream) const {
+  DCHECK(!s_commandBuffer) << "Snapshots can't be taken while ticking.";
+
+  BinaryWriter writer{stream};
+  writer.write(kSnapshotMagic);
+  writer.write(kSnapshotVersion);
+
+  writer.write(m_tickCount);
+  writer.write(m_random.getState());
+  writer.write(m_totalMinerals);
+
+  // All the slots, including the free ones, so that the handles objects hold
+  // keep resolving and new objects get the same handles they would have.
+  writer.write(static_cast<uint32_t>(m_slots.size()));
+  for (const auto& slot : m_slots) {
+    writer.write(slot.generation);
+  }
+  writer.write(static_cast<uint32_t>(m_freeSlots.size()));
+  for (const auto& index : m_freeSlots) {
+    writer.write(index);
+  }
+
+  // The objects in bucket order.
+  writer.write(static_cast<uint32_t>(getObjectCount()));
+  for (const auto& bucket : m_objects) {
+    for (const auto& object : bucket) {
+      writer.write(static_cast<uint8_t>(object->getType()));
+      writer.write(object->getHandle().index);
+      object->saveState(&writer);
+    }
+  }
+
+  // Who is watching which slot.
+  for (const auto& slot : m_slots) {
+    writer.write(static_cast<uint32_t>(slot.watchers.size()));
+    for (const auto& watcher : slot.watchers) {
+      writer.write(watcher.index);
+      writer.write(watcher.generation);
+    }
+  }
+
+  // The order of the objects in the spatial indices, which is the order that
+  // queries return them in.
+  std::vector<Object*> indexedObjects;
+  for (const auto& spatialIndex : m_spatialIndices) {
+    indexedObjects.clear();
+    spatialIndex.getObjects(&indexedObjects);
+    writer.write(static_cast<uint32_t>(indexedObjects.size()));
+    for (const auto& object : indexedObjects) {
+      writer.write(object->getHandle().index);
+    }
+  }
+
+  const std::vector<Link*>& links = m_powerGrid.getLinks();
+  writer.write(static_cast<uint32_t>(links.size()));
+  for (const auto& link : links) {
+    writer.write(link->getSource()->getHandle().index);
+    writer.write(link->getDestination()->getHandle().index);
+  }
+
+  m_projectileSystem.saveState(&writer);
+
+  return writer.isOk();
+}
+
+bool Universe::loadSnapshot(std::istream* stream) {
+  DCHECK(!s_commandBuffer) << "Snapshots can't be loaded while ticking.";
+
+  BinaryReader reader{stream};
+
+  m_isLoadingSnapshot = true;
+  const bool loaded = readSnapshot(&reader) && reader.isOk();
+  if (!loaded) {
+    removeAllObjects();
+    m_tickCount = 0;
+    m_totalMinerals = 0;
+  }
+  m_isLoadingSnapshot = false;
+
+  return loaded;
+}
+
+void Universe::setThreadCount(size_t threadCount) {
+  DCHECK(!s_commandBuffer) << "Can't change threads while ticking.";
+
+  m_threadPool =
+      std::make_unique<ThreadPool>(std::max<size_t>(threadCount, 1));
+}
+
+Object* Universe::placeObject(ObjectType objectType,
+                              const sf::Vector2f& pos) {
+  switch (objectType) {
+    case ObjectType::CommandCenter:
+    case ObjectType::PowerRelay:
+    case ObjectType::Miner:
+    case ObjectType::Turret:
+    case ObjectType::EnemyShip:
+      break;
+
+    default:
+      LOG(Error) << "Objects of type " << static_cast<int>(objectType)
+                 << " can't be placed.";
+      return nullptr;
+  }
+
+  if (m_commandLog) {
+    m_commandLog->record(PlacementCommand{m_tickCount, objectType, pos});
+  }
+
+  return addObject(createObject(objectType, pos));
 }
 
 Object* Universe::addObject(std::unique_ptr<Object> object) {
-  // If we are in the destructor, we don't do anything with the object, so it
-  // will just be destroyed.
-  if (m_inDestructor) {
+  DCHECK(!s_commandBuffer) << "Objects must be added through defer.";
+
+  // If we are in the destructor or loading a snapshot, we don't do anything
+  // with the object, so it will just be destroyed.
+  if (m_inDestructor || m_isLoadingSnapshot) {
     return nullptr;
   }
 
   Object* result = object.get();
+
+  // The object gets a handle right away, even if it only ends up in the
+  // universe at the end of the tick.
+  assignHandle(result);
+
   if (m_useIncomingObjectList) {
     m_incomingObjects.emplace_back(object.release());
   } else {
     addObjectInternal(object.release());
   }
+
+  // Now that the object has a handle, it can start watching other objects.
+  result->onAddedToUniverse();
+
   return result;
 }
 
 void Universe::removeObject(Object* object) {
-  // We don't remove objects if we're in the destructor, because we're busy
-  // deleting everything anyway.
-  if (m_inDestructor) {
+  // We don't remove objects if we're in the destructor or loading a snapshot,
+  // because we're busy replacing everything anyway.
+  if (m_inDestructor || m_isLoadingSnapshot) {
     return;
   }
 
-  if (m_useIncomingObjectList) {
-    m_incomingRemoveObjects.emplace_back(object);
+  if (s_commandBuffer) {
+    s_commandBuffer->removeObject(object);
+  } else if (m_useIncomingObjectList) {
+    m_incomingRemoveObjects.emplace_back(object->getHandle());
   } else {
     removeObjectInternal(object);
+    compactBuckets();
+  }
+}
+
+void Universe::defer(std::function<void()> function) {
+  if (s_commandBuffer) {
+    s_commandBuffer->defer(std::move(function));
+  } else {
+    function();
+  }
+}
+
+size_t Universe::getObjectCount() const {
+  size_t count = 0;
+  for (const auto& bucket : m_objects) {
+    count += bucket.size();
+  }
+  return count;
+}
+
+Object* Universe::resolve(const ObjectHandle& handle) const {
+  if (handle.index >= m_slots.size()) {
+    return nullptr;
+  }
+
+  const ObjectSlot& slot = m_slots[handle.index];
+  if (slot.generation != handle.generation) {
+    return nullptr;
+  }
+
+  return slot.object;
+}
+
+void Universe::watchObject(const ObjectHandle& object, Object* watcher) {
+  if (s_commandBuffer) {
+    s_commandBuffer->watchObject(object, watcher);
+    return;
+  }
+
+  if (!resolve(object) || resolve(watcher->getHandle()) != watcher) {
+    return;
+  }
+
+  // Watchers are taken off the list when they are removed, but drop any that
+  // are gone anyway, so the list can't grow without bound.
+  std::vector<ObjectHandle>& watchers = m_slots[object.index].watchers;
+  watchers.erase(std::remove_if(std::begin(watchers), std::end(watchers),
+                                [this](const ObjectHandle& handle) {
+                                  return !resolve(handle);
+                                }),
+                 std::end(watchers));
+
+  const ObjectHandle& watcherHandle = watcher->getHandle();
+  if (std::find(std::begin(watchers), std::end(watchers), watcherHandle) ==
+      std::end(watchers)) {
+    watchers.push_back(watcherHandle);
+    m_slots[watcherHandle.index].watching.push_back(object);
+  }
+}
+
+void Universe::unwatchObject(const ObjectHandle& object, Object* watcher) {
+  if (s_commandBuffer) {
+    s_commandBuffer->unwatchObject(object, watcher);
+    return;
+  }
+
+  if (!resolve(object)) {
+    return;
+  }
+
+  eraseHandle(&m_slots[object.index].watchers, watcher->getHandle());
+  if (resolve(watcher->getHandle()) == watcher) {
+    eraseHandle(&m_slots[watcher->getHandle().index].watching, object);
   }
 }
 
 Object* Universe::findObjectAt(const sf::Vector2f& pos) const {
-  for (size_t i = m_objects.size() - 1; i != -1; --i) {
-    if (m_objects[i] && m_objects[i]->getBounds().contains(pos)) {
-      return m_objects[i];
+  // Look at the types in reverse render order so that we find the top most
+  // object first.  Only the objects that are close enough for their bounds to
+  // reach pos are looked at.
+  std::vector<Object*> candidates;
+  for (size_t type = kObjectTypeCount; type-- > 0;) {
+    const SpatialIndex& index = m_spatialIndices[type];
+    if (!index.getObjectCount()) {
+      continue;
+    }
+
+    const float extent = index.getMaxExtent();
+    candidates.clear();
+    index.findObjectsInRect(sf::FloatRect{pos.x - extent, pos.y - extent,
+                                          extent * 2.f, extent * 2.f},
+                            &candidates);
+
+    // Newer objects of a type are rendered underneath older ones, so the one
+    // closest to the front of the bucket is on top.
+    Object* topObject = nullptr;
+    for (const auto& object : candidates) {
+      if ((!topObject || object->m_bucketIndex < topObject->m_bucketIndex) &&
+          object->getBounds().contains(pos)) {
+        topObject = object;
+      }
+    }
+
+    if (topObject) {
+      return topObject;
     }
   }
 
@@ -92,153 +425,590 @@ Object* Universe::findObjectAt(const sf::Vector2f& pos) const {
   return nullptr;
 }
 
+void Universe::findObjectsInRadius(ObjectType objectType,
+                                   const sf::Vector2f& origin, float radius,
+                                   std::vector<Object*>* objectsOut) const {
+  spatialIndexFor(objectType).findObjectsInRadius(origin, radius, objectsOut);
+}
+
 void Universe::findObjectsInRadius(const std::set<ObjectType>& objectTypes,
                                    const sf::Vector2f& origin, float radius,
                                    std::vector<Object*>* objectsOut) const {
-  DCHECK(objectsOut);
+  for (const auto& objectType : objectTypes) {
+    findObjectsInRadius(objectType, origin, radius, objectsOut);
+  }
+}
 
-  for (const auto& object : m_objects) {
-    if (!objectTypes.count(object->getType())) {
-      continue;
-    }
+size_t Universe::findObjectsInRect(ObjectType objectType,
+                                   const sf::FloatRect& rect,
+                                   std::vector<Object*>* objectsOut) const {
+  const SpatialIndex& index = spatialIndexFor(objectType);
 
-    float distance = object->calculateDistanceFrom(origin);
-    if (distance <= radius) {
-      objectsOut->emplace_back(object);
-    }
-  }
+  // Grow the rect so that we also find objects that are positioned outside of
+  // it, but still reach into it.
+  const float extent = index.getMaxExtent();
+  sf::FloatRect searchRect{rect.left - extent, rect.top - extent,
+                           rect.width + extent * 2.f,
+                           rect.height + extent * 2.f};
+
+  const size_t first = objectsOut->size();
+  index.findObjectsInRect(searchRect, objectsOut);
+  const size_t consideredCount = objectsOut->size() - first;
+
+  // Only keep the objects that really overlap.
+  auto begin = std::begin(*objectsOut) + first;
+  auto end = std::remove_if(begin, std::end(*objectsOut), [&rect](Object* o) {
+    return !o->getBounds().intersects(rect);
+  });
+  objectsOut->erase(end, std::end(*objectsOut));
+
+  // The index doesn't keep any order, so put the objects in render order,
+  // which is newest first.
+  std::sort(std::begin(*objectsOut) + first, std::end(*objectsOut),
+            [](Object* left, Object* right) {
+              return left->m_bucketIndex > right->m_bucketIndex;
+            });
+
+  return consideredCount;
 }
 
 Object* Universe::findClosestObjectOfType(const sf::Vector2f& pos,
                                           ObjectType objectType,
                                           float maxRange) {
-  float bestDistance{std::numeric_limits<float>::max()};
-  Object* bestObject{nullptr};
+  const KdTree& tree = m_closestObjectTrees[static_cast<size_t>(objectType)];
+  if (!tree.isStale()) {
+    return tree.findClosestObject(pos, maxRange);
+  }
 
-  for (const auto& object : m_objects) {
-    if (object->getType() != objectType) {
-      continue;
-    }
+  return spatialIndexFor(objectType).findClosestObject(pos, maxRange);
+}
 
-    float distance = object->calculateDistanceFrom(pos);
+void Universe::moveObject(Object* object, const sf::Vector2f& pos) {
+  if (s_commandBuffer) {
+    s_commandBuffer->moveObject(object, pos);
+    return;
+  }
 
-    if (distance > maxRange) {
-      continue;
-    }
+  object->m_pos = pos;
 
-    if (distance < bestDistance) {
-      bestDistance = distance;
-      bestObject = object;
-    }
+  // Ghost objects are moved around while they are being placed, but they are
+  // not in the indices, so the tree for their type stays as it is.
+  if (!object->m_isIndexed) {
+    return;
   }
 
-  return bestObject;
+  spatialIndexFor(object->getType()).update(object);
+  invalidateClosestObjectTree(object->getType());
 }
 
-void Universe::createLinksFor(Object* object) {
-  if (!Object::isStructure(object)) {
+void Universe::spawnBullet(const sf::Vector2f& pos, float direction,
+                           float speed) {
+  if (s_commandBuffer) {
+    s_commandBuffer->spawnBullet(pos, direction, speed);
     return;
   }
 
-  std::vector<Object*> objectsToLinkTo;
+  addObject(std::make_unique<Bullet>(this, pos, direction, speed));
+}
 
-  if (object->getType() == ObjectType::PowerRelay) {
-    // If we are creating links from a power relay, we create a link between us
-    // and every other power relay in range.
-    findObjectsInRadius(Object::objectTypesForStructures(), object->getPos(),
-                        1500.f, &objectsToLinkTo);
-  } else {
-    // If we are a normal structure, we create links between us and the closest
-    // power relay.
-    Object* linkTo = findClosestObjectOfType(object->getPos(),
-                                             ObjectType::PowerRelay, 1500.f);
-    if (linkTo) {
-      objectsToLinkTo.emplace_back(linkTo);
-    }
+void Universe::mineAsteroid(const ObjectHandle& asteroid, int32_t amount) {
+  if (s_commandBuffer) {
+    s_commandBuffer->mineAsteroid(asteroid, amount);
+    return;
   }
 
-  for (auto& linkTo : objectsToLinkTo) {
-    // Can't link to ourselves.
-    if (linkTo == object) {
-      continue;
-    }
+  Object* object = resolve(asteroid);
+  if (!object) {
+    return;
+  }
 
-    if (linkTo->getType() == ObjectType::PowerRelay) {
-      // Make sure there isn't a link between object and linkTo already.
-      auto it = std::find_if(std::begin(m_links), std::end(m_links),
-                             [&object, &linkTo](Link* link) {
-                               return link->getSource() == object &&
-                                      link->getDestination() == linkTo;
-                             });
-      if (it != std::end(m_links)) {
-        // We already have a link between these objects, so continue to the
-        // next.
-        continue;
-      }
+  adjustMinerals(static_cast<Asteroid*>(object)->mine(amount));
+}
 
-      // Add the new link.
-      m_links.push_back(new Link{this, object, linkTo});
-    }
+void Universe::placeRailMissiles(Turret* turret) {
+  if (s_commandBuffer) {
+    s_commandBuffer->placeRailMissiles(turret);
+    return;
+  }
+
+  turret->placeMissilesOnRail();
+}
 
-    // We also create links the other way.
-    createLinksFor(linkTo);
+void Universe::launchMissile(Turret* turret, const ObjectHandle& target) {
+  if (s_commandBuffer) {
+    s_commandBuffer->launchMissile(turret, target);
+    return;
+  }
+
+  turret->launchMissileAt(target);
+}
+
+void Universe::setProjectileVelocity(Projectile* projectile,
+                                     const sf::Vector2f& velocity) {
+  if (s_commandBuffer) {
+    s_commandBuffer->setProjectileVelocity(projectile, velocity);
+    return;
   }
+
+  m_projectileSystem.setVelocity(projectile, velocity);
 }
 
-void Universe::adjustPower(int32_t amount) {
-  m_totalPower += amount;
+void Universe::setProjectileCollisionTypes(Projectile* projectile,
+                                           uint32_t typeMask) {
+  if (s_commandBuffer) {
+    s_commandBuffer->setProjectileCollisionTypes(projectile, typeMask);
+    return;
+  }
+
+  m_projectileSystem.setCollisionTypes(projectile, typeMask);
 }
 
 void Universe::adjustMinerals(int32_t amount) {
+  if (s_commandBuffer) {
+    s_commandBuffer->adjustMinerals(amount);
+    return;
+  }
+
   m_totalMinerals += amount;
 }
 
 void Universe::tick(float adjustment) {
-  // We start with 0 power so that we can calculate the total.
-  m_totalPower = 0;
+  const MemoryPool::Stats allocationsBefore = MemoryPool::getStats();
 
   m_useIncomingObjectList = true;
 
-  // Update each object.
-  for (auto& object : m_objects) {
-    object->tick(adjustment);
+  // Remember where everything was so that the view can render between this
+  // tick and the last.
+  m_tickOrder.clear();
+  for (auto& bucket : m_objects) {
+    for (auto& object : bucket) {
+      object->m_previousPos = object->m_pos;
+      m_tickOrder.push_back(object);
+    }
+  }
+
+  // The objects search for structures while they are ticked, so bring the
+  // trees and indices up to date while nothing is reading them.
+  rebuildClosestObjectTrees();
+  for (auto& spatialIndex : m_spatialIndices) {
+    spatialIndex.dropEmptyCells();
   }
 
-  // Update all the links.
-  for (auto& link : m_links) {
-    link->tick(adjustment);
+  findTurretTargets();
+
+  // Update each object.  The objects are ticked in fixed size chunks that
+  // each record their changes into their own command buffer.  The buffers are
+  // applied in chunk order, so the outcome doesn't depend on the number of
+  // threads or on which thread ticked which chunk.
+  const size_t chunkCount =
+      (m_tickOrder.size() + kObjectsPerTickChunk - 1) / kObjectsPerTickChunk;
+  while (m_commandBuffers.size() < chunkCount) {
+    m_commandBuffers.push_back(std::make_unique<CommandBuffer>());
   }
 
+  m_threadPool->run(chunkCount, [this, adjustment](size_t chunk) {
+    s_commandBuffer = m_commandBuffers[chunk].get();
+
+    const size_t begin = chunk * kObjectsPerTickChunk;
+    const size_t end =
+        std::min(begin + kObjectsPerTickChunk, m_tickOrder.size());
+    for (size_t i = begin; i < end; ++i) {
+      m_tickOrder[i]->tick(adjustment);
+    }
+
+    s_commandBuffer = nullptr;
+  });
+
+  for (size_t i = 0; i < chunkCount; ++i) {
+    m_commandBuffers[i]->apply(this);
+  }
+
+  // Move all the projectiles and get rid of the ones that went out of range.
+  // The system moves them without telling us one by one, so the indices are
+  // brought up to date in one go.
+  m_projectileSystem.tick(adjustment, &m_expiredProjectiles);
+  for (const auto& projectileType : {ObjectType::Bullet, ObjectType::Missile}) {
+    spatialIndexFor(projectileType).update(bucketFor(projectileType));
+  }
+
+  // Hit whatever the projectiles ran into on the way, in one pass over all of
+  // them.
+  m_projectileSystem.findCollisions(m_objects, &m_collisions);
+  for (auto& collision : m_collisions) {
+    collision.projectile->onCollision(collision.object);
+  }
+  m_collisions.clear();
+
+  for (auto& projectile : m_expiredProjectiles) {
+    removeObject(projectile);
+  }
+  m_expiredProjectiles.clear();
+
   m_useIncomingObjectList = false;
 
   // Remove items that is in the incoming remove list.
   if (!m_incomingRemoveObjects.empty()) {
-    for (auto& incomingObject : m_incomingRemoveObjects) {
-      removeObjectInternal(incomingObject);
+    for (auto& handle : m_incomingRemoveObjects) {
+      // The object might have been removed already if it was removed more than
+      // once.
+      Object* object = resolve(handle);
+      if (object) {
+        removeObjectInternal(object);
+      }
     }
     m_incomingRemoveObjects.clear();
+    compactBuckets();
   }
 
   // Add any objects that might be in the incoming object list.
   if (!m_incomingObjects.empty()) {
-    std::copy(std::begin(m_incomingObjects), std::end(m_incomingObjects),
-              std::back_inserter(m_objects));
+    for (auto& incomingObject : m_incomingObjects) {
+      ObjectBucket& bucket = bucketFor(incomingObject->getType());
+      incomingObject->m_bucketIndex = bucket.size();
+      bucket.push_back(incomingObject);
+      spatialIndexFor(incomingObject->getType()).insert(incomingObject);
+      invalidateClosestObjectTree(incomingObject->getType());
+    }
     m_incomingObjects.clear();
   }
+
+  ++m_tickCount;
+
+  m_lastTickRemovalNotificationCount = m_removalNotificationCount;
+  m_removalNotificationCount = 0;
+
+  const MemoryPool::Stats& allocationsAfter = MemoryPool::getStats();
+  m_lastTickAllocationStats.allocations =
+      allocationsAfter.allocations - allocationsBefore.allocations;
+  m_lastTickAllocationStats.chunkAllocations =
+      allocationsAfter.chunkAllocations - allocationsBefore.chunkAllocations;
+}
+
+void Universe::rebuildClosestObjectTrees() {
+  for (const auto& objectType : Object::objectTypesForStructures()) {
+    KdTree& tree = m_closestObjectTrees[static_cast<size_t>(objectType)];
+    if (tree.isStale()) {
+      tree.build(bucketFor(objectType));
+    }
+  }
+}
+
+void Universe::findTurretTargets() {
+  m_searchingTurrets.clear();
+  m_searchingTurretPositions.clear();
+  for (auto& object : bucketFor(ObjectType::Turret)) {
+    Turret* turret = static_cast<Turret*>(object);
+    if (turret->isSearchingForTarget()) {
+      m_searchingTurrets.push_back(turret);
+      m_searchingTurretPositions.push_back(turret->getPos());
+    }
+  }
+
+  if (m_searchingTurrets.empty()) {
+    return;
+  }
+
+  m_turretTargetJoin.run(bucketFor(ObjectType::EnemyShip),
+                         m_searchingTurretPositions, Turret::kMaxAttachRange,
+                         &m_turretTargets);
+  for (size_t i = 0; i < m_searchingTurrets.size(); ++i) {
+    m_searchingTurrets[i]->offerTarget(m_turretTargets[i]);
+  }
+}
+
+void Universe::assignHandle(Object* object) {
+  uint32_t index;
+  if (!m_freeSlots.empty()) {
+    index = m_freeSlots.back();
+    m_freeSlots.pop_back();
+  } else {
+    index = static_cast<uint32_t>(m_slots.size());
+    m_slots.emplace_back();
+
+    // Most objects watch, or are watched by, only a few others.  Slots are
+    // reused by every kind of object and their lists keep their room, so
+    // making room up front keeps watching from allocating later on.
+    m_slots.back().watchers.reserve(kHandlesPerSlot);
+    m_slots.back().watching.reserve(kHandlesPerSlot);
+  }
+
+  ObjectSlot& slot = m_slots[index];
+  slot.object = object;
+  object->m_handle = ObjectHandle{index, slot.generation};
+}
+
+void Universe::releaseHandle(Object* object) {
+  ObjectSlot& slot = m_slots[object->m_handle.index];
+  slot.object = nullptr;
+
+  // Bump the generation so that all the handles to the object stop resolving.
+  ++slot.generation;
+
+  m_freeSlots.push_back(object->m_handle.index);
 }
 
 void Universe::addObjectInternal(Object* object) {
-  // Find the place where we have to insert the new object.
-  auto it = std::lower_bound(std::begin(m_objects), std::end(m_objects), object,
-                             [](Object* left, Object* right) {
-                               return left->getType() < right->getType();
-                             });
+  // Buckets keep their objects in the order they were added, which is what
+  // rendering newest first within a type goes by.
+  ObjectBucket& bucket = bucketFor(object->getType());
+  object->m_bucketIndex = bucket.size();
+  bucket.push_back(object);
+  spatialIndexFor(object->getType()).insert(object);
+  invalidateClosestObjectTree(object->getType());
+
+  // Link the newly added structure into the power grid.
+  if (Object::isStructure(object)) {
+    m_powerGrid.addStructure(object);
+    m_powerGrid.linkStructure(object);
+  }
+}
+
+std::unique_ptr<Object> Universe::createObject(ObjectType objectType,
+                                               const sf::Vector2f& pos) {
+  switch (objectType) {
+    case ObjectType::Asteroid:
+      return std::make_unique<Asteroid>(this, pos, 0);
+
+    case ObjectType::CommandCenter:
+      return std::make_unique<CommandCenter>(this, pos);
+
+    case ObjectType::PowerRelay:
+      return std::make_unique<PowerRelay>(this, pos);
+
+    case ObjectType::Miner:
+      return std::make_unique<Miner>(this, pos);
+
+    case ObjectType::Turret:
+      return std::make_unique<Turret>(this, pos);
+
+    case ObjectType::EnemyShip:
+      return std::make_unique<EnemyShip>(this, pos);
+
+    case ObjectType::Bullet:
+      return std::make_unique<Bullet>(this, pos, 0.f, 0.f);
+
+    case ObjectType::Missile: {
+      sf::Vector2f missilePos = pos;
+      return std::make_unique<Missile>(this, missilePos, 0.f);
+    }
+  }
+
+  return nullptr;
+}
+
+bool Universe::readSnapshot(BinaryReader* reader) {
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  reader->read(&magic);
+  reader->read(&version);
+  if (magic != kSnapshotMagic) {
+    LOG(Error) << "Not a snapshot.";
+    return false;
+  }
+  if (version != kSnapshotVersion) {
+    LOG(Error) << "Snapshot version " << version << " is not supported.";
+    return false;
+  }
+
+  removeAllObjects();
 
-  // Insert the new object.
-  m_objects.insert(it, object);
+  // Objects use random numbers when they are created, so the generator is
+  // only restored once they are all in place.
+  uint64_t randomState = 0;
+  reader->read(&m_tickCount);
+  reader->read(&randomState);
+  reader->read(&m_totalMinerals);
 
-  // Create links for the newly added object.
-  createLinksFor(object);
+  // The slots.  They are added one at a time, so that a corrupt count runs out
+  // of data before it runs out of memory.
+  size_t slotCount = 0;
+  reader->readCount(ObjectHandle::kInvalidIndex, &slotCount);
+  for (size_t i = 0; i < slotCount && reader->isOk(); ++i) {
+    m_slots.emplace_back();
+    reader->read(&m_slots.back().generation);
+  }
+
+  size_t freeSlotCount = 0;
+  reader->readCount(slotCount, &freeSlotCount);
+  for (size_t i = 0; i < freeSlotCount && reader->isOk(); ++i) {
+    uint32_t index = 0;
+    if (!reader->read(&index) || index >= slotCount) {
+      return false;
+    }
+    m_freeSlots.push_back(index);
+  }
+
+  // The objects.  Each one is created with its default settings and then
+  // takes its state from the snapshot.
+  size_t objectCount = 0;
+  reader->readCount(slotCount, &objectCount);
+  for (size_t i = 0; i < objectCount && reader->isOk(); ++i) {
+    uint8_t type = 0;
+    uint32_t index = 0;
+    reader->read(&type);
+    if (!reader->read(&index) || type >= kObjectTypeCount ||
+        index >= slotCount || m_slots[index].object) {
+      return false;
+    }
+
+    Object* object =
+        createObject(static_cast<ObjectType>(type), sf::Vector2f{}).release();
+    object->m_handle = ObjectHandle{index, m_slots[index].generation};
+    m_slots[index].object = object;
+
+    ObjectBucket& bucket = bucketFor(object->getType());
+    object->m_bucketIndex = bucket.size();
+    bucket.push_back(object);
+
+    object->loadState(reader);
+  }
+
+  for (const auto& index : m_freeSlots) {
+    if (m_slots[index].object) {
+      return false;
+    }
+  }
+
+  for (auto& slot : m_slots) {
+    size_t watcherCount = 0;
+    reader->readCount(slotCount, &watcherCount);
+    for (size_t i = 0; i < watcherCount && reader->isOk(); ++i) {
+      ObjectHandle watcher;
+      reader->read(&watcher.index);
+      reader->read(&watcher.generation);
+      slot.watchers.push_back(watcher);
+    }
+  }
+
+  // Who is watching what follows from the lists of watchers.  Watchers that
+  // are gone are dropped, in case the snapshot was saved by a version that
+  // left them behind.
+  for (uint32_t index = 0; index < m_slots.size() && reader->isOk(); ++index) {
+    ObjectSlot& slot = m_slots[index];
+    const ObjectHandle watched{index, slot.generation};
+    slot.watchers.erase(
+        std::remove_if(std::begin(slot.watchers), std::end(slot.watchers),
+                       [this](const ObjectHandle& handle) {
+                         return !resolve(handle);
+                       }),
+        std::end(slot.watchers));
+    if (!slot.object) {
+      slot.watchers.clear();
+    }
+    for (const auto& watcher : slot.watchers) {
+      m_slots[watcher.index].watching.push_back(watched);
+    }
+  }
+
+  // Insert the objects into the spatial indices in the order they were saved
+  // in, so that queries return them in the same order.
+  for (size_t type = 0; type < kObjectTypeCount && reader->isOk(); ++type) {
+    size_t indexedCount = 0;
+    reader->readCount(slotCount, &indexedCount);
+    if (indexedCount != m_objects[type].size()) {
+      return false;
+    }
+
+    for (size_t i = 0; i < indexedCount; ++i) {
+      uint32_t index = 0;
+      if (!reader->read(&index) || index >= slotCount) {
+        return false;
+      }
+
+      Object* object = m_slots[index].object;
+      if (!object || static_cast<size_t>(object->getType()) != type ||
+          object->m_isIndexed) {
+        return false;
+      }
+      m_spatialIndices[type].insert(object);
+      m_closestObjectTrees[type].markStale();
+    }
+  }
+
+  // The structures go into the power grid as they are, because their links
+  // are restored from the snapshot.
+  for (const auto& structureType : Object::objectTypesForStructures()) {
+    for (const auto& structure : bucketFor(structureType)) {
+      m_powerGrid.addStructure(structure);
+    }
+  }
+
+  size_t linkCount = 0;
+  reader->readCount(std::numeric_limits<uint32_t>::max(), &linkCount);
+  for (size_t i = 0; i < linkCount && reader->isOk(); ++i) {
+    uint32_t sourceIndex = 0;
+    uint32_t destinationIndex = 0;
+    reader->read(&sourceIndex);
+    if (!reader->read(&destinationIndex) || sourceIndex >= slotCount ||
+        destinationIndex >= slotCount) {
+      return false;
+    }
+
+    Object* source = m_slots[sourceIndex].object;
+    Object* destination = m_slots[destinationIndex].object;
+    if (!source || !destination || !Object::isStructure(source) ||
+        !Object::isStructure(destination)) {
+      return false;
+    }
+    if (!m_powerGrid.addLink(source, destination)) {
+      return false;
+    }
+  }
+
+  if (!m_projectileSystem.loadState(reader, *this)) {
+    return false;
+  }
+
+  m_random.setState(randomState);
+
+  return reader->isOk();
+}
+
+void Universe::compactBuckets() {
+  for (size_t type = 0; type < kObjectTypeCount; ++type) {
+    if (!m_bucketHasHoles[type]) {
+      continue;
+    }
+    m_bucketHasHoles[type] = false;
+
+    ObjectBucket& bucket = m_objects[type];
+    size_t count = 0;
+    for (auto& object : bucket) {
+      if (object) {
+        object->m_bucketIndex = count;
+        bucket[count++] = object;
+      }
+    }
+    bucket.resize(count);
+  }
+}
+
+void Universe::removeAllObjects() {
+  // Clear the indices first, because they touch the objects they hold.
+  for (auto& spatialIndex : m_spatialIndices) {
+    spatialIndex.clear();
+  }
+  for (auto& tree : m_closestObjectTrees) {
+    tree.markStale();
+  }
+
+  for (auto& bucket : m_objects) {
+    for (auto& object : bucket) {
+      delete object;
+    }
+    bucket.clear();
+  }
+
+  for (auto& object : m_incomingObjects) {
+    delete object;
+  }
+  m_incomingObjects.clear();
+  m_incomingRemoveObjects.clear();
+
+  m_powerGrid.clear();
+
+  m_slots.clear();
+  m_freeSlots.clear();
 }
 
 void Universe::createAsteroids(const sf::Vector2f& origin, float minRadius,
@@ -247,35 +1017,86 @@ void Universe::createAsteroids(const sf::Vector2f& origin, float minRadius,
 
   for (size_t i = 0; i < count; ++i) {
     // Get a random direction between 0 and 360.
-    float randDirection = static_cast<float>(std::rand() % 36000) / 100.f;
+    float randDirection = m_random.nextFloat(0.f, 360.f);
 
-    // Get a random radius between 100 and the max radius.
-    float randRadius =
-        minRadius + static_cast<float>(
-                        std::rand() % (static_cast<int32_t>(
-                                          std::roundl(maxRadius) - minRadius)));
+    // Get a random radius between the min and max radius.
+    float randRadius = m_random.nextFloat(minRadius, maxRadius);
 
     // Get a random starting amount.
-    int32_t mineralCount = (std::rand() % 1000) + 100;
+    int32_t mineralCount = m_random.nextInt(100, 1100);
 
-    sf::Vector2f pos{origin.x + randRadius * std::cosf(randDirection),
-                     origin.y + randRadius * std::sinf(randDirection)};
+    sf::Vector2f pos{origin.x + randRadius * std::cos(randDirection),
+                     origin.y + randRadius * std::sin(randDirection)};
     addObject(std::make_unique<Asteroid>(this, pos, mineralCount));
   }
 }
 
 void Universe::removeObjectInternal(Object* object) {
-  // We don't erase the object from the list yet, we set it to null and then
-  // delete it when it is convenient.
-  auto it = std::find(std::begin(m_objects), std::end(m_objects), object);
-  if (it == std::end(m_objects)) {
+  const ObjectHandle handle = object->getHandle();
+  if (resolve(handle) != object) {
     LOG(Error) << "Trying to delete object that doesn't exist!";
     return;
   }
 
-  delete *it;
-  m_objects.erase(it);
+  ObjectBucket& bucket = bucketFor(object->getType());
+  if (object->m_bucketIndex < bucket.size()) {
+    // Leave a hole in our place, so that the objects after us keep their
+    // order.  The holes are closed up once all the removals are done.
+    bucket[object->m_bucketIndex] = nullptr;
+    object->m_bucketIndex = std::numeric_limits<size_t>::max();
+    m_bucketHasHoles[static_cast<size_t>(object->getType())] = true;
+  } else {
+    // The object was added during this tick and isn't in a bucket yet.
+    auto it = std::find(std::begin(m_incomingObjects),
+                        std::end(m_incomingObjects), object);
+    if (it != std::end(m_incomingObjects)) {
+      m_incomingObjects.erase(it);
+    }
+  }
+
+  spatialIndexFor(object->getType()).remove(object);
+  invalidateClosestObjectTree(object->getType());
+
+  // Don't leave links pointing at the object once it is deleted.
+  if (Object::isStructure(object)) {
+    m_powerGrid.removeStructure(object);
+  }
+
+  // Take the list of watchers before releasing the slot.  The slots might be
+  // reallocated by watchers adding objects when they are notified.  The list
+  // is swapped with a spare one, so that neither of them has to allocate once
+  // they have grown.  Watchers can remove more objects while they are
+  // notified, so there is a spare list for every level of that.
+  std::vector<ObjectHandle> watchers;
+  if (!m_spareHandleLists.empty()) {
+    watchers.swap(m_spareHandleLists.back());
+    m_spareHandleLists.pop_back();
+  }
+  watchers.swap(m_slots[handle.index].watchers);
+
+  // Stop watching everything we were watching, so we don't leave our handle
+  // behind on their lists.
+  for (const auto& watched : m_slots[handle.index].watching) {
+    if (resolve(watched)) {
+      eraseHandle(&m_slots[watched.index].watchers, handle);
+    }
+  }
+  m_slots[handle.index].watching.clear();
+
+  releaseHandle(object);
+
+  delete object;
+
+  // Let everyone that is interested know that the object is gone.
+  for (const auto& watcherHandle : watchers) {
+    Object* watcher = resolve(watcherHandle);
+    if (watcher) {
+      eraseHandle(&m_slots[watcherHandle.index].watching, handle);
+      watcher->onWatchedObjectRemoved(handle);
+      ++m_removalNotificationCount;
+    }
+  }
 
-  // Emit the signal that the specified object has been removed.
-  m_objectRemovedSignal.emit(object);
+  watchers.clear();
+  m_spareHandleLists.push_back(std::move(watchers));
 }
@@ -15,56 +15,191 @@
 #ifndef UNIVERSE_UNIVERSE_H_
 #define UNIVERSE_UNIVERSE_H_
 
+#include <array>
+#include <functional>
+#include <istream>
 #include <memory>
+#include <ostream>
 #include <set>
 #include <vector>
 
 #include <nucleus/macros.h>
-#include <nucleus/utils/signals.h>
 
 #include "game/resource_manager.h"
+#include "particles/particle_system.h"
 #include "universe/camera.h"
+#include "universe/closest_object_join.h"
+#include "universe/command_buffer.h"
+#include "universe/kd_tree.h"
+#include "universe/object_handle.h"
 #include "universe/objects/object.h"
-
+#include "universe/power_grid.h"
+#include "universe/projectile_system.h"
+#include "universe/spatial_index.h"
+#include "utils/binary_stream.h"
+#include "utils/memory_pool.h"
+#include "utils/random.h"
+#include "utils/thread_pool.h"
+
+class CommandLog;
 class Link;
 class Object;
+class Projectile;
+class Turret;
 
 class Universe {
 public:
-  using ObjectRemovedSignal = nu::Signal<void(Object*)>;
-
-  // Construct the universe with the specified viewport size.
-  explicit Universe(ResourceManager* resourceManager);
+  // Construct the universe.  Everything random in the universe comes from a
+  // generator seeded with seed, so two universes with the same seed that get
+  // the same input end up in exactly the same state.
+  Universe(ResourceManager* resourceManager, uint64_t seed);
   ~Universe();
 
   // Return the resource manager attached to this universe.
   ResourceManager* getResourceManager() const { return m_resourceManager; }
 
-  // Add or remove objects from the universe.
+  // Return the random number generator of the universe.  It must not be used
+  // while objects are being ticked, because the order objects are ticked in
+  // across threads is not fixed.
+  Random* getRandom();
+
+  // Return the number of ticks the universe has run.
+  uint64_t getTickCount() const { return m_tickCount; }
+
+  // Return a hash of the complete simulation state.  Two universes are in the
+  // same state if their hashes match.
+  uint64_t calculateStateHash() const;
+
+  // Write the complete simulation state to a snapshot that loadSnapshot can
+  // restore.  Returns false if the stream could not be written.  Snapshots
+  // can't be taken while ticking.
+  bool saveSnapshot(std::ostream* stream) const;
+
+  // Replace everything in the universe with a snapshot written by
+  // saveSnapshot.  The universe then continues exactly as the one that was
+  // saved would have.  Returns false if the snapshot is not valid, in which
+  // case the universe is left empty.
+  bool loadSnapshot(std::istream* stream);
+
+  // Return the network of links between the structures in the universe.
+  PowerGrid* getPowerGrid() { return &m_powerGrid; }
+
+  // Return the system that moves all the projectiles in the universe.
+  ProjectileSystem* getProjectileSystem() { return &m_projectileSystem; }
+
+  // Return the system that draws all the particles in the universe.
+  ParticleSystem* getParticleSystem() { return &m_particleSystem; }
+
+  // Get/set the number of threads that objects are ticked on.  The result of
+  // a tick is the same no matter how many threads there are.
+  size_t getThreadCount() const { return m_threadPool->getThreadCount(); }
+  void setThreadCount(size_t threadCount);
+
+  // Record every object placed with placeObject into the given log.  Pass
+  // null to stop recording.
+  void setCommandLog(CommandLog* commandLog) { m_commandLog = commandLog; }
+
+  // Create an object of the given type at pos and add it to the universe.
+  // This is how objects are placed from outside of the simulation, so that
+  // the placement can be recorded and replayed.  Returns null if objects of
+  // the given type can't be placed.
+  Object* placeObject(ObjectType objectType, const sf::Vector2f& pos);
+
+  // Add or remove objects from the universe.  Objects can't be added while
+  // they are being ticked; create them in a function passed to defer instead.
   Object* addObject(std::unique_ptr<Object> object);
   void removeObject(Object* object);
 
+  // Run the given function once all the objects are done ticking, or right
+  // away if we are not ticking.  Objects being ticked may only change
+  // themselves, so anything that changes other objects or adds new ones and
+  // doesn't have a function of its own below has to go through here.
+  // Functions run in the same order every time.
+  void defer(std::function<void()> function);
+
+  // Return the number of objects in the universe.  Objects added during the
+  // current tick are only counted once the tick is done.
+  size_t getObjectCount() const;
+
+  // Return the object the handle refers to, or null if the object has been
+  // removed from the universe.
+  Object* resolve(const ObjectHandle& handle) const;
+
+  // Let the watcher know through Object::onWatchedObjectRemoved when the given
+  // object is removed from the universe.  The watcher must already be in the
+  // universe.  Watching an object more than once has no effect.
+  void watchObject(const ObjectHandle& object, Object* watcher);
+
+  // Stop letting the watcher know when the given object is removed.
+  void unwatchObject(const ObjectHandle& object, Object* watcher);
+
+  // Return the number of removal notifications that were sent to watchers
+  // during the last tick.
+  size_t getRemovalNotificationCount() const {
+    return m_lastTickRemovalNotificationCount;
+  }
+
+  // Return the number of pooled allocations made during the last tick and how
+  // many of them had to go to the heap for a new chunk.  Once all the pools
+  // have grown large enough, the chunk allocations stay at zero.
+  const MemoryPool::Stats& getAllocationStats() const {
+    return m_lastTickAllocationStats;
+  }
+
   // Find the object that is at the specified location.  This function takes
   // z-order into account for objects that might be overlapping.
   Object* findObjectAt(const sf::Vector2f& pos) const;
 
   // Find a list of objects with in a radius to the origin with the specified
   // type.
+  void findObjectsInRadius(ObjectType objectType, const sf::Vector2f& origin,
+                           float radius,
+                           std::vector<Object*>* objectsOut) const;
   void findObjectsInRadius(const std::set<ObjectType>& objectTypes,
                            const sf::Vector2f& origin, float radius,
                            std::vector<Object*>* objectsOut) const;
 
+  // Find all the objects of the given type whose bounds intersect rect, in
+  // render order.  Return the number of objects that had to be looked at.
+  size_t findObjectsInRect(ObjectType objectType, const sf::FloatRect& rect,
+                           std::vector<Object*>* objectsOut) const;
+
   // Find the closest object to the given position of the specified type.
   Object* findClosestObjectOfType(
       const sf::Vector2f& pos, ObjectType objectType,
       float maxRange = std::numeric_limits<float>::max());
 
-  // Create links for the specified object.  This will only create links in one direction.
-  void createLinksFor(Object* object);
-
-  // Power
-  int32_t getPower() const { return m_totalPower; }
-  void adjustPower(int32_t amount);
+  // Move the object to the given position.  Objects being ticked see the
+  // positions from the start of the tick, so the move only happens once all
+  // the objects are done.
+  void moveObject(Object* object, const sf::Vector2f& pos);
+
+  // Fire a bullet from pos in the given direction.  While objects are being
+  // ticked, the bullet is only added once they are all done.
+  void spawnBullet(const sf::Vector2f& pos, float direction, float speed);
+
+  // Mine up to amount minerals from the asteroid and add them to our
+  // minerals.  Several miners can mine the same asteroid, so while objects are
+  // being ticked, this only happens once they are all done.
+  void mineAsteroid(const ObjectHandle& asteroid, int32_t amount);
+
+  // Move the missiles on the turret's rail into place for the direction it is
+  // facing, or launch the first missile that is still on the rail at the
+  // target.  The missiles are objects of their own, so while objects are being
+  // ticked, this only happens once they are all done.
+  void placeRailMissiles(Turret* turret);
+  void launchMissile(Turret* turret, const ObjectHandle& target);
+
+  // Change the velocity of a projectile or the types of objects it runs into
+  // (see ProjectileSystem).  The projectile system is shared by all the
+  // projectiles, so while objects are being ticked, this only happens once
+  // they are all done.
+  void setProjectileVelocity(Projectile* projectile,
+                             const sf::Vector2f& velocity);
+  void setProjectileCollisionTypes(Projectile* projectile, uint32_t typeMask);
+
+  // Power.  See PowerGrid for the power of the separate parts of the grid.
+  int32_t getPower() const { return m_powerGrid.getTotalPower(); }
 
   // Minerals
   int32_t getMinerals() const { return m_totalMinerals; }
@@ -73,31 +208,106 @@ public:
   // Update the entire universe.  This should run at 60fps.
   void tick(float adjustment);
 
-  // Signal that will let slots know that we removed an object.
-  ObjectRemovedSignal& getObjectRemovedSignal() {
-    return m_objectRemovedSignal;
-  }
-
 private:
   friend class UniverseView;
 
-  // Add an object internally.  This keeps the list of objects sorted in the
-  // correct order.
+  // Objects of a single type.
+  using ObjectBucket = std::vector<Object*>;
+
+  // A slot that an object lives in.  The generation is bumped every time the
+  // object in the slot is removed so that old handles no longer resolve.
+  struct ObjectSlot {
+    Object* object{nullptr};
+    uint32_t generation{0};
+
+    // Objects that want to know when the object in this slot is removed.
+    std::vector<ObjectHandle> watchers;
+
+    // Objects that the object in this slot is watching, so that it can be
+    // taken off their lists of watchers when it is removed first.
+    std::vector<ObjectHandle> watching;
+  };
+
+  // Return the bucket that holds objects of the given type.
+  ObjectBucket& bucketFor(ObjectType objectType) {
+    return m_objects[static_cast<size_t>(objectType)];
+  }
+
+  // Return the spatial index that holds objects of the given type.
+  SpatialIndex& spatialIndexFor(ObjectType objectType) {
+    return m_spatialIndices[static_cast<size_t>(objectType)];
+  }
+  const SpatialIndex& spatialIndexFor(ObjectType objectType) const {
+    return m_spatialIndices[static_cast<size_t>(objectType)];
+  }
+
+  // Let the closest object tree of the given type know that objects of the
+  // type were added, removed or moved.
+  void invalidateClosestObjectTree(ObjectType objectType) {
+    m_closestObjectTrees[static_cast<size_t>(objectType)].markStale();
+  }
+
+  // Rebuild the closest object trees of the structure types that changed.
+  void rebuildClosestObjectTrees();
+
+  // Offer every turret that is searching for a target the closest enemy ship
+  // in its range, all in one pass.
+  void findTurretTargets();
+
+  // Assign a slot and handle to a newly added object.
+  void assignHandle(Object* object);
+
+  // Release the slot of an object that is being removed.
+  void releaseHandle(Object* object);
+
+  // Add an object internally.  This adds the object to the bucket for its type.
   void addObjectInternal(Object* object);
 
+  // Create an object of the given type at pos with its default settings.
+  std::unique_ptr<Object> createObject(ObjectType objectType,
+                                       const sf::Vector2f& pos);
+
+  // Read the contents of a snapshot into the universe.  Returns false as soon
+  // as something in the snapshot is not valid.
+  bool readSnapshot(BinaryReader* reader);
+
+  // Delete all the objects and links without notifying anyone.
+  void removeAllObjects();
+
   // Create count number of asteroids within the given radius around the given
   // origin.
   void createAsteroids(const sf::Vector2f& origin, float minRadius,
                        float maxRadius, size_t count);
 
-  // Do the actual work of deleting an object.
+  // Do the actual work of deleting an object.  This leaves a hole in the
+  // object's bucket, so compactBuckets has to be called once the removals are
+  // done.
   void removeObjectInternal(Object* object);
 
+  // Close the holes that removed objects left in the buckets, keeping the
+  // remaining objects in order.
+  void compactBuckets();
+
   // The resource manager we load everything from.
   ResourceManager* m_resourceManager{nullptr};
 
-  // The entire list of objects that exist in the universe.
-  std::vector<Object*> m_objects;
+  // Generates all the random numbers in the universe.
+  Random m_random;
+
+  // The number of ticks we have run.
+  uint64_t m_tickCount{0};
+
+  // The log that placed objects are recorded in, if any.
+  CommandLog* m_commandLog{nullptr};
+
+  // All the objects that exist in the universe, bucketed by type.  The buckets
+  // are in ObjectType order, which is also the order we render in.  Each
+  // bucket holds its objects in the order they were added, and the newest
+  // objects of a type are rendered first, underneath the older ones.
+  std::array<ObjectBucket, kObjectTypeCount> m_objects;
+
+  // Whether the bucket of each type has holes left by removed objects.
+  std::array<bool, kObjectTypeCount> m_bucketHasHoles{};
 
   // If this is true, we add objects to the incoming list and not directly to
   // the object list.
@@ -106,24 +316,85 @@ private:
   // A list of objects that was added while we were updateing other objects.
   std::vector<Object*> m_incomingObjects;
 
-  // A list used for all objects that need to be deleted.
-  std::vector<Object*> m_incomingRemoveObjects;
+  // A list used for all objects that need to be deleted.  We store handles, so
+  // that objects that were removed more than once in a tick are only deleted
+  // once.
+  std::vector<ObjectHandle> m_incomingRemoveObjects;
+
+  // The slots objects live in.  Handles index into this.
+  std::vector<ObjectSlot> m_slots;
 
-  // All the links that exist in the universe.
-  std::vector<Link*> m_links;
+  // Indices of slots that are not in use.
+  std::vector<uint32_t> m_freeSlots;
+
+  // Empty lists of handles that removing an object swaps with the watchers of
+  // the object, so that the capacity of the lists is reused.
+  std::vector<std::vector<ObjectHandle>> m_spareHandleLists;
+
+  // Index of the objects of each type by position that serves all the spatial
+  // queries.
+  std::array<SpatialIndex, kObjectTypeCount> m_spatialIndices;
+
+  // Trees that answer closest object queries for the structure types.
+  // Structures are placed and destroyed far less often than ships look for
+  // them, so a tree is only rebuilt at the start of a tick when its type
+  // changed.  Until then, queries fall back to the spatial index.
+  std::array<KdTree, kObjectTypeCount> m_closestObjectTrees;
+
+  // Finds the targets of all the searching turrets at once.
+  ClosestObjectJoin m_turretTargetJoin;
+
+  // The turrets that are searching for targets during the current tick, where
+  // they are and what they found.
+  std::vector<Turret*> m_searchingTurrets;
+  std::vector<sf::Vector2f> m_searchingTurretPositions;
+  std::vector<Object*> m_turretTargets;
+
+  // Moves all the projectiles in the universe.
+  ProjectileSystem m_projectileSystem;
+
+  // Runs the object ticks.
+  std::unique_ptr<ThreadPool> m_threadPool;
+
+  // All the objects in the order they are ticked.  Rebuilt every tick.
+  std::vector<Object*> m_tickOrder;
+
+  // The changes recorded by each chunk of m_tickOrder while ticking.
+  std::vector<std::unique_ptr<CommandBuffer>> m_commandBuffers;
+
+  // Projectiles that went out of range during the current tick.
+  std::vector<Projectile*> m_expiredProjectiles;
+
+  // Projectiles that ran into something during the current tick.
+  std::vector<ProjectileSystem::Collision> m_collisions;
+
+  // Draws the particles of all the emitters in the universe.
+  ParticleSystem m_particleSystem;
+
+  // The links between all the structures in the universe.
+  PowerGrid m_powerGrid;
 
   // Whether we are in the destructor or not.  If we are in the destructor, we
   // don't add or remove any more objects.
   bool m_inDestructor{false};
 
-  // The total amount of power in the universe.
-  int32_t m_totalPower{0};
+  // Whether we are loading a snapshot.  Objects that try to add or remove
+  // other objects while they are being recreated are ignored, because the
+  // snapshot already contains everything.
+  bool m_isLoadingSnapshot{false};
 
   // The total amount of minerals in the universe.
   int32_t m_totalMinerals{5000};
 
-  // Signal that is emitted when an object is removed from the universe.
-  ObjectRemovedSignal m_objectRemovedSignal;
+  // The number of removal notifications sent to watchers so far this tick.
+  size_t m_removalNotificationCount{0};
+
+  // The number of removal notifications sent to watchers during the last
+  // tick.
+  size_t m_lastTickRemovalNotificationCount{0};
+
+  // The pooled allocations made during the last tick.
+  MemoryPool::Stats m_lastTickAllocationStats;
 
   DISALLOW_COPY_AND_ASSIGN(Universe);
 };
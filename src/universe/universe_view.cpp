@@ -14,15 +14,20 @@
 
 #include "universe/universe_view.h"
 
+#include <sstream>
+
+#include <SFML/Graphics/RenderTarget.hpp>
+
+#include "particles/particle_emitter.h"
 #include "universe/link.h"
 #include "universe/objects/object.h"
 #include "universe/objects/structures/miner.h"
 #include "universe/objects/structures/turret.h"
-#include "universe/objects/units/enemy_ship.h"
 #include "universe/universe.h"
 
 UniverseView::UniverseView(el::Context* context, Universe* universe)
-  : el::View(context), m_universe(universe), m_hud{this} {
+  : el::View(context), m_universe(universe), m_hud{this},
+    m_renderer(universe) {
 // Set up the mouse position shape.
 
 #if SHOW_UNIVERSE_MOUSE_POS
@@ -31,21 +36,37 @@ UniverseView::UniverseView(el::Context* context, Universe* universe)
                             m_mousePosShape.getGlobalBounds().height / 2.f);
   m_mousePosShape.setFillColor(sf::Color{0, 0, 255, 255});
 #endif  // SHOW_UNIVERSE_MOUSE_POS
+
+#if SHOW_UNIVERSE_STATS
+  sf::Font* font = m_universe ? m_universe->getResourceManager()->getFont(
+                                    ResourceManager::Font::Default)
+                              : nullptr;
+  if (font) {
+    m_statsText.setFont(*font);
+    m_statsText.setColor(sf::Color{255, 255, 255, 255});
+    m_statsText.setCharacterSize(16);
+  }
+#endif  // SHOW_UNIVERSE_STATS
 }
 
 UniverseView::~UniverseView() {
 }
 
+void UniverseView::setInterpolation(float interpolation) {
+  m_renderer.setInterpolation(interpolation);
+}
+
 void UniverseView::startPlacingObject(std::unique_ptr<Object> object) {
   m_ghostObject = std::move(object);
 }
 
 void UniverseView::stopPlacingObject(bool place) {
-  if (place) {
-    m_universe->addObject(std::move(m_ghostObject));
-  } else {
-    m_ghostObject.reset();
+  // The ghost only shows what will be placed.  The real object is created by
+  // the universe so that the placement can be recorded.
+  if (place && m_ghostObject) {
+    m_universe->placeObject(m_ghostObject->getType(), m_ghostObject->getPos());
   }
+  m_ghostObject.reset();
 }
 
 bool UniverseView::onMousePressed(sf::Event& event) {
@@ -64,8 +85,9 @@ bool UniverseView::onMousePressed(sf::Event& event) {
   sf::Vector2f universePos{m_camera.mousePosToUniversePos(m_mouseStartDragPos)};
 
   // See if the mouse is currently over an object.
-  m_mousePressedObject = m_universe->findObjectAt(universePos);
-  if (m_mousePressedObject) {
+  Object* pressedObject = m_universe->findObjectAt(universePos);
+  if (pressedObject) {
+    m_mousePressedObject = pressedObject->getHandle();
     m_mouseHandler = MouseHandler::Object;
     return true;
   }
@@ -149,10 +171,12 @@ void UniverseView::onMouseReleased(sf::Event& event) {
     sf::Vector2f universePos{m_camera.mousePosToUniversePos(
         sf::Vector2i{event.mouseButton.x, event.mouseButton.y})};
 
-    if (m_mousePressedObject == m_universe->findObjectAt(universePos)) {
-      m_hud.setSelectedObject(m_mousePressedObject);
-      m_mousePressedObject = nullptr;
+    Object* pressedObject = m_universe->resolve(m_mousePressedObject);
+    if (pressedObject &&
+        pressedObject == m_universe->findObjectAt(universePos)) {
+      m_hud.setSelectedObject(pressedObject);
     }
+    m_mousePressedObject.reset();
   } else if (m_mouseHandler == MouseHandler::Camera) {
     // If we released the mouse, but we didn't drag past the camera move
     // threshold, then it counts as a cancel selection or placing the ghost
@@ -209,6 +233,11 @@ void UniverseView::layout(const sf::IntRect& rect) {
   View::layout(rect);
 
   m_camera.layout(rect);
+
+#if SHOW_UNIVERSE_STATS
+  m_statsText.setPosition(sf::Vector2f{static_cast<float>(rect.left + 10),
+                                       static_cast<float>(rect.top + 10)});
+#endif
 }
 
 void UniverseView::draw(sf::RenderTarget& target,
@@ -219,19 +248,73 @@ void UniverseView::draw(sf::RenderTarget& target,
   // Set the new view to our camera view.
   target.setView(m_camera.getView());
 
-  // Render all the links in the universe.
-  for (const auto& link : m_universe->m_links) {
-    target.draw(*link, states);
+  m_drawStats = DrawStats{};
+
+  // Only the part of the universe inside this rect is visible.
+  const sf::FloatRect viewRect{m_camera.getViewRect()};
+
+  // Render all the links in the universe that are visible.  Their geometry
+  // is cached, so this is cheap while the structures stay where they are.
+  for (const auto& link : m_universe->m_powerGrid.getLinks()) {
+    ++m_drawStats.objectsConsidered;
+
+    if (!m_renderer.getLinkGeometry(*link).getBounds().intersects(viewRect)) {
+      continue;
+    }
+
+    m_renderer.addLink(*link);
+    ++m_drawStats.objectsDrawn;
   }
+  m_drawStats.drawCalls += m_renderer.flush(target, states);
+
+  // Render the visible objects, one type at a time in render order.
+  for (size_t i = 0; i < m_universe->m_objects.size(); ++i) {
+    const ObjectType type = static_cast<ObjectType>(i);
 
-  // Render the objects.
-  for (const auto& object : m_universe->m_objects) {
-    target.draw(*object, states);
+    // All the particles are drawn in one go, underneath the units that emit
+    // them.
+    if (type == ObjectType::EnemyShip) {
+      target.draw(m_universe->m_particleSystem, states);
+      ++m_drawStats.drawCalls;
+    }
+
+    // Miner lasers can reach into the view from miners that are outside of
+    // it, so look for miners in range of the view and draw their lasers
+    // underneath all the miners.
+    if (type == ObjectType::Miner) {
+      const float range = Miner::kMiningRange;
+      const sf::FloatRect laserRect{viewRect.left - range, viewRect.top - range,
+                                    viewRect.width + range * 2.f,
+                                    viewRect.height + range * 2.f};
+      m_visibleObjects.clear();
+      m_drawStats.objectsConsidered +=
+          m_universe->findObjectsInRect(type, laserRect, &m_visibleObjects);
+      for (const auto& object : m_visibleObjects) {
+        m_drawStats.objectsDrawn += m_renderer.addLasers(
+            *static_cast<const Miner*>(object), viewRect);
+      }
+    }
+
+    m_visibleObjects.clear();
+    m_drawStats.objectsConsidered +=
+        m_universe->findObjectsInRect(type, viewRect, &m_visibleObjects);
+
+    // The whole layer is drawn in one go.
+    for (const auto& object : m_visibleObjects) {
+      m_renderer.add(*object);
+      ++m_drawStats.objectsDrawn;
+    }
+    m_drawStats.drawCalls += m_renderer.flush(target, states);
   }
 
-  // Render the ghost object and link over the existing objects.
+  // Render the ghost object over the existing objects.
   if (m_ghostObject) {
-    target.draw(*m_ghostObject);
+    if (m_ghostObject->getType() == ObjectType::Miner) {
+      m_renderer.addLasers(*static_cast<const Miner*>(m_ghostObject.get()),
+                           viewRect);
+    }
+    m_renderer.add(*m_ghostObject);
+    m_drawStats.drawCalls += m_renderer.flush(target, states);
   }
 
   // Render all the debugging stuff.
@@ -249,7 +332,34 @@ void UniverseView::draw(sf::RenderTarget& target,
 
   // Render the hud after we reset the view.
   target.draw(m_hud, states);
+
+#if SHOW_UNIVERSE_STATS
+  updateStatsText();
+  target.draw(m_statsText, states);
+#endif
+}
+
+#if SHOW_UNIVERSE_STATS
+void UniverseView::updateStatsText() const {
+  size_t objectCount = m_universe->m_powerGrid.getLinks().size();
+  for (const auto& bucket : m_universe->m_objects) {
+    objectCount += bucket.size();
+  }
+
+  const MemoryPool::Stats& allocations = m_universe->getAllocationStats();
+
+  std::ostringstream ss;
+  ss << "Objects: " << m_drawStats.objectsDrawn << " drawn, "
+     << m_drawStats.objectsConsidered << " considered, " << objectCount
+     << " total\n";
+  ss << "Draw calls: " << m_drawStats.drawCalls << "\n";
+  ss << "Particles: " << ParticleEmitter::getTotalParticleCount() << " ("
+     << ParticleEmitter::getTotalMemoryUsage() / 1024 << " KB)\n";
+  ss << "Pool allocations last tick: " << allocations.allocations << " ("
+     << allocations.chunkAllocations << " new chunks)";
+  m_statsText.setString(ss.str());
 }
+#endif  // SHOW_UNIVERSE_STATS
 
 void UniverseView::updateGhostPosition(const sf::Vector2f& universeMousePos) {
   // Move the ghost object to the new mouse position.
@@ -259,5 +369,5 @@ void UniverseView::updateGhostPosition(const sf::Vector2f& universeMousePos) {
 }
 
 void UniverseView::placeEnemyShip(const sf::Vector2f& pos) {
-  m_universe->addObject(std::make_unique<EnemyShip>(m_universe, pos));
+  m_universe->placeObject(ObjectType::EnemyShip, pos);
 }
@@ -16,15 +16,20 @@
 #define UNIVERSE_UNIVERSE_VIEW_H_
 
 #include <memory>
+#include <vector>
 
 #include <elastic/views/color_view.h>
 #include <nucleus/config.h>
+#include <SFML/Graphics/Text.hpp>
 
 #include "universe/camera.h"
 #include "universe/hud.h"
+#include "universe/object_handle.h"
+#include "universe/object_renderer.h"
 
 #if BUILD(DEBUG)
 #define SHOW_UNIVERSE_MOUSE_POS 1
+#define SHOW_UNIVERSE_STATS 1
 #endif
 
 class Universe;
@@ -33,6 +38,19 @@ class Link;
 
 class UniverseView : public el::View {
 public:
+  // Counts of what was drawn in a frame.
+  struct DrawStats {
+    // The number of objects and links we had to look at to find the visible
+    // ones.
+    size_t objectsConsidered{0};
+
+    // The number of objects and links that were visible and drawn.
+    size_t objectsDrawn{0};
+
+    // The number of draw calls made.
+    size_t drawCalls{0};
+  };
+
   explicit UniverseView(el::Context* context, Universe* universe = nullptr);
   virtual ~UniverseView() override;
 
@@ -42,6 +60,13 @@ public:
   // Return the camera we use in this view.
   const Camera& getCamera() const { return m_camera; }
 
+  // Return what was drawn in the last frame.
+  const DrawStats& getDrawStats() const { return m_drawStats; }
+
+  // Set how far the universe is between its last tick and the next one, so
+  // that objects can be drawn between their positions of the two ticks.
+  void setInterpolation(float interpolation);
+
   // Start placing the given object.
   void startPlacingObject(std::unique_ptr<Object> object);
 
@@ -77,6 +102,11 @@ private:
   // Place an enemy ship at the given universe location.
   void placeEnemyShip(const sf::Vector2f& pos);
 
+#if SHOW_UNIVERSE_STATS
+  // Update the stats overlay with the latest numbers.
+  void updateStatsText() const;
+#endif
+
   // The universe we are looking at.
   Universe* m_universe;
 
@@ -93,7 +123,7 @@ private:
   sf::Vector2i m_mouseStartDragPos;
 
   // The object that we pressed the mouse on.
-  Object* m_mousePressedObject{nullptr};
+  ObjectHandle m_mousePressedObject;
 
   // Whether moving the camera has moved past the threshold.
   bool m_cameraMovedPastThreshold{false};
@@ -105,11 +135,26 @@ private:
   // universe yet.
   std::unique_ptr<Object> m_ghostObject;
 
+  // What was drawn in the last frame.
+  mutable DrawStats m_drawStats;
+
+  // Scratch space for the objects that are visible in a frame.
+  mutable std::vector<Object*> m_visibleObjects;
+
+  // Builds the geometry for the visible objects.  Kept between frames so that
+  // it doesn't have to reallocate.
+  mutable ObjectRenderer m_renderer;
+
 #if SHOW_UNIVERSE_MOUSE_POS
   // A shape to show where the current mouse position is in the universe.
   sf::CircleShape m_mousePosShape;
 #endif
 
+#if SHOW_UNIVERSE_STATS
+  // Text showing the draw stats and other counters over the view.
+  mutable sf::Text m_statsText;
+#endif
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(UniverseView);
 };
 
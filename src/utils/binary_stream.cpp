@@ -0,0 +1,61 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#include "utils/binary_stream.h"
+
+#include <cstring>
+
+BinaryWriter::BinaryWriter(std::ostream* stream) : m_stream(stream) {
+}
+
+BinaryWriter::~BinaryWriter() {
+}
+
+void BinaryWriter::writeBytes(const void* data, size_t size) {
+  m_stream->write(static_cast<const char*>(data),
+                  static_cast<std::streamsize>(size));
+}
+
+BinaryReader::BinaryReader(std::istream* stream) : m_stream(stream) {
+}
+
+BinaryReader::~BinaryReader() {
+}
+
+bool BinaryReader::readCount(size_t maxCount, size_t* countOut) {
+  uint32_t count = 0;
+  if (!read(&count) || count > maxCount) {
+    m_isOk = false;
+    *countOut = 0;
+    return false;
+  }
+
+  *countOut = count;
+  return true;
+}
+
+bool BinaryReader::readBytes(void* data, size_t size) {
+  if (!m_isOk) {
+    std::memset(data, 0, size);
+    return false;
+  }
+
+  m_stream->read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+  if (m_stream->gcount() != static_cast<std::streamsize>(size)) {
+    std::memset(data, 0, size);
+    m_isOk = false;
+  }
+
+  return m_isOk;
+}
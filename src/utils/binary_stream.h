@@ -0,0 +1,101 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#ifndef UTILS_BINARY_STREAM_H_
+#define UTILS_BINARY_STREAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+#include <nucleus/macros.h>
+#include <SFML/System/Vector2.hpp>
+
+// Writes plain values to a stream as raw bytes, in the byte order of the
+// machine.  Used for snapshots, which are only meant to be read back on the
+// same kind of machine that wrote them.
+class BinaryWriter {
+public:
+  explicit BinaryWriter(std::ostream* stream);
+  ~BinaryWriter();
+
+  // Returns true if everything so far was written successfully.
+  bool isOk() const { return !m_stream->fail(); }
+
+  template <typename T>
+  void write(const T& value) {
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                  "Only plain values can be written.");
+    writeBytes(&value, sizeof(value));
+  }
+
+  void write(const sf::Vector2f& value) {
+    write(value.x);
+    write(value.y);
+  }
+
+private:
+  void writeBytes(const void* data, size_t size);
+
+  // The stream we write to.
+  std::ostream* m_stream;
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(BinaryWriter);
+};
+
+// Reads values written by BinaryWriter.  Once a read fails, because the stream
+// ended or a value was out of range, all further reads fail too, so callers
+// can read a whole block of values and only check isOk at the end.
+class BinaryReader {
+public:
+  explicit BinaryReader(std::istream* stream);
+  ~BinaryReader();
+
+  // Returns true if everything so far was read successfully.
+  bool isOk() const { return m_isOk; }
+
+  // Mark the data as invalid, so that isOk returns false from now on.
+  void fail() { m_isOk = false; }
+
+  template <typename T>
+  bool read(T* value) {
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                  "Only plain values can be read.");
+    return readBytes(value, sizeof(*value));
+  }
+
+  bool read(sf::Vector2f* value) {
+    return read(&value->x) && read(&value->y);
+  }
+
+  // Read a count that was written as a uint32_t and fail if it is larger than
+  // maxCount.  This keeps corrupt data from making us allocate huge amounts of
+  // memory.
+  bool readCount(size_t maxCount, size_t* countOut);
+
+private:
+  bool readBytes(void* data, size_t size);
+
+  // The stream we read from.
+  std::istream* m_stream;
+
+  // Whether all the reads so far succeeded.
+  bool m_isOk{true};
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(BinaryReader);
+};
+
+#endif  // UTILS_BINARY_STREAM_H_
@@ -0,0 +1,60 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#include "utils/fixed_timestep.h"
+
+#include <nucleus/logging.h>
+
+namespace {
+
+// The rate that an adjustment of 1.0 represents.
+const float kBaseTicksPerSecond = 60.f;
+
+// The most steps we run in a single frame.  If the simulation can't keep up,
+// running even more steps would only make the next frame slower.
+const size_t kMaxStepsPerFrame = 5;
+
+}  // namespace
+
+FixedTimestep::FixedTimestep(float ticksPerSecond) {
+  setTicksPerSecond(ticksPerSecond);
+}
+
+FixedTimestep::~FixedTimestep() {
+}
+
+void FixedTimestep::setTicksPerSecond(float ticksPerSecond) {
+  DCHECK(ticksPerSecond > 0.f);
+
+  m_ticksPerSecond = ticksPerSecond;
+  m_stepAdjustment = kBaseTicksPerSecond / ticksPerSecond;
+  m_accumulator = 0.f;
+}
+
+size_t FixedTimestep::advance(float adjustment) {
+  m_accumulator += adjustment;
+
+  size_t steps = 0;
+  while (m_accumulator >= m_stepAdjustment) {
+    m_accumulator -= m_stepAdjustment;
+    ++steps;
+  }
+
+  if (steps > kMaxStepsPerFrame) {
+    steps = kMaxStepsPerFrame;
+    m_accumulator = 0.f;
+  }
+
+  return steps;
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#ifndef UTILS_FIXED_TIMESTEP_H_
+#define UTILS_FIXED_TIMESTEP_H_
+
+#include <cstddef>
+
+#include <nucleus/macros.h>
+
+// Turns the variable time between frames into a whole number of fixed size
+// simulation steps.  Time is measured in adjustments, where 1.0 is one frame
+// at 60fps, so the simulation can keep treating an adjustment of 1.0 as its
+// base tick.  Time left over that doesn't make up a whole step is carried
+// over to the next frame and can be used to interpolate between the last two
+// simulation states when rendering.
+class FixedTimestep {
+public:
+  explicit FixedTimestep(float ticksPerSecond);
+  ~FixedTimestep();
+
+  // Get/set the number of simulation steps per second.
+  float getTicksPerSecond() const { return m_ticksPerSecond; }
+  void setTicksPerSecond(float ticksPerSecond);
+
+  // Return the adjustment that each simulation step should be ticked with.
+  float getStepAdjustment() const { return m_stepAdjustment; }
+
+  // Add the time that passed since the last frame and return the number of
+  // steps that should be ticked.  If the simulation fell too far behind, the
+  // extra time is dropped rather than trying to catch up.
+  size_t advance(float adjustment);
+
+  // Return how far we are between the last step and the next one, in the
+  // range [0, 1).
+  float getInterpolation() const { return m_accumulator / m_stepAdjustment; }
+
+private:
+  // The number of simulation steps per second.
+  float m_ticksPerSecond;
+
+  // The adjustment of a single step.
+  float m_stepAdjustment;
+
+  // Time that passed that was not consumed by a step yet.
+  float m_accumulator{0.f};
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(FixedTimestep);
+};
+
+#endif  // UTILS_FIXED_TIMESTEP_H_
@@ -21,7 +21,7 @@ const float kPi = 3.1415f;
 float distanceBetween(const sf::Vector2f& p1, const sf::Vector2f& p2) {
   float xd = p2.x - p1.x;
   float yd = p2.y - p1.y;
-  return std::sqrtf(xd * xd + yd * yd);
+  return std::sqrt(xd * xd + yd * yd);
 }
 
 float directionBetween(const sf::Vector2f& p1, const sf::Vector2f& p2) {
@@ -30,3 +30,8 @@ float directionBetween(const sf::Vector2f& p1, const sf::Vector2f& p2) {
   float direction = radToDeg(std::atan2(dy, dx));
   return wrap(direction, 0.f, 360.f);
 }
+
+sf::Vector2f vectorInDirection(float direction, float length) {
+  const float rad = degToRad(direction);
+  return sf::Vector2f{std::cos(rad) * length, std::sin(rad) * length};
+}
@@ -46,4 +46,8 @@ float distanceBetween(const sf::Vector2f& p1, const sf::Vector2f& p2);
 // Calculate the direction between two points.
 float directionBetween(const sf::Vector2f& p1, const sf::Vector2f& p2);
 
+// Return a vector of the given length pointing in the given direction (in
+// degrees).
+sf::Vector2f vectorInDirection(float direction, float length);
+
 #endif  // UTILS_MATH_H_
@@ -0,0 +1,79 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#include "utils/memory_pool.h"
+
+#include <algorithm>
+
+#include <nucleus/logging.h>
+
+// static
+MemoryPool::Stats MemoryPool::s_stats;
+
+MemoryPool::MemoryPool(size_t blockSize, size_t blocksPerChunk)
+  : m_blocksPerChunk(blocksPerChunk) {
+  DCHECK(blocksPerChunk > 0);
+
+  // Every block must be able to hold the free list link and must be aligned
+  // for any type.
+  const size_t alignment = alignof(std::max_align_t);
+  blockSize = std::max(blockSize, sizeof(FreeBlock));
+  m_blockSize = (blockSize + alignment - 1) / alignment * alignment;
+}
+
+MemoryPool::~MemoryPool() {
+}
+
+void* MemoryPool::allocate() {
+  if (!m_freeList) {
+    allocateChunk();
+  }
+
+  FreeBlock* block = m_freeList;
+  m_freeList = block->next;
+
+  ++s_stats.allocations;
+
+  return block;
+}
+
+void MemoryPool::free(void* block) {
+  if (!block) {
+    return;
+  }
+
+  // Put the block at the front of the free list so that it's reused first
+  // while it's still in the cache.
+  FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+  freeBlock->next = m_freeList;
+  m_freeList = freeBlock;
+}
+
+void MemoryPool::allocateChunk() {
+  std::unique_ptr<char[]> chunk{new char[m_blockSize * m_blocksPerChunk]};
+
+  // Link all the blocks in the chunk into the free list, keeping them in
+  // address order.
+  char* data = chunk.get();
+  for (size_t i = m_blocksPerChunk; i > 0; --i) {
+    FreeBlock* block =
+        reinterpret_cast<FreeBlock*>(data + (i - 1) * m_blockSize);
+    block->next = m_freeList;
+    m_freeList = block;
+  }
+
+  m_chunks.push_back(std::move(chunk));
+
+  ++s_stats.chunkAllocations;
+}
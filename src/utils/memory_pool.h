@@ -0,0 +1,152 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#ifndef UTILS_MEMORY_POOL_H_
+#define UTILS_MEMORY_POOL_H_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <nucleus/macros.h>
+
+// Hands out fixed size blocks of memory from chunks that are allocated on the
+// heap only when the pool runs dry.  Freed blocks are kept in a free list and
+// reused, so once a pool has grown to the high water mark of its type, new and
+// delete don't touch the heap at all.
+class MemoryPool {
+public:
+  // Totals over all the pools in the process.
+  struct Stats {
+    // The number of blocks handed out.
+    size_t allocations{0};
+
+    // The number of chunks that had to be allocated on the heap.
+    size_t chunkAllocations{0};
+  };
+
+  // Return the totals over all the pools since the process started.
+  static const Stats& getStats() { return s_stats; }
+
+  MemoryPool(size_t blockSize, size_t blocksPerChunk);
+  ~MemoryPool();
+
+  // Return a block from the pool.
+  void* allocate();
+
+  // Return a block to the pool.
+  void free(void* block);
+
+private:
+  // Freed blocks are linked together through their own memory.
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  // Allocate a new chunk and add all of its blocks to the free list.
+  void allocateChunk();
+
+  // The totals over all the pools.
+  static Stats s_stats;
+
+  // The size of each block, rounded up so that every block is aligned.
+  size_t m_blockSize;
+
+  // The number of blocks we allocate at a time.
+  size_t m_blocksPerChunk;
+
+  // All the chunks we allocated.
+  std::vector<std::unique_ptr<char[]>> m_chunks;
+
+  // The first free block.
+  FreeBlock* m_freeList{nullptr};
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryPool);
+};
+
+// Route all new and delete calls for ClassName through a MemoryPool that only
+// holds objects of ClassName.  Subclasses of ClassName that don't declare
+// their own pool fall back to the heap.
+#define DECLARE_POOLED(ClassName)                                              \
+  \
+public:                                                                        \
+  static void* operator new(size_t size);                                      \
+  static void operator delete(void* ptr, size_t size)
+
+#define DEFINE_POOLED(ClassName, BlocksPerChunk)                               \
+  static MemoryPool& poolFor##ClassName() {                                    \
+    static MemoryPool pool{sizeof(ClassName), BlocksPerChunk};                 \
+    return pool;                                                               \
+  }                                                                            \
+  void* ClassName::operator new(size_t size) {                                 \
+    if (size != sizeof(ClassName)) {                                           \
+      return ::operator new(size);                                             \
+    }                                                                          \
+    return poolFor##ClassName().allocate();                                    \
+  }                                                                            \
+  void ClassName::operator delete(void* ptr, size_t size) {                    \
+    if (size != sizeof(ClassName)) {                                           \
+      ::operator delete(ptr);                                                  \
+      return;                                                                  \
+    }                                                                          \
+    poolFor##ClassName().free(ptr);                                            \
+  }                                                                            \
+  static_assert(BlocksPerChunk > 0, "Pools need at least one block per chunk")
+
+// An allocator for node based containers, like std::unordered_map, that takes
+// single nodes from a MemoryPool shared by all the containers with the same
+// node type.  Arrays, like the bucket arrays of hash maps, still come from the
+// heap, but those only grow when the container grows past its largest size.
+template <typename T>
+class PoolAllocator {
+public:
+  using value_type = T;
+
+  PoolAllocator() = default;
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U>&) {}
+
+  T* allocate(size_t count) {
+    if (count != 1) {
+      return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+    return static_cast<T*>(pool().allocate());
+  }
+
+  void deallocate(T* ptr, size_t count) {
+    if (count != 1) {
+      ::operator delete(ptr);
+      return;
+    }
+    pool().free(ptr);
+  }
+
+  template <typename U>
+  bool operator==(const PoolAllocator<U>&) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const PoolAllocator<U>&) const {
+    return false;
+  }
+
+private:
+  static MemoryPool& pool() {
+    static MemoryPool pool{sizeof(T), 256};
+    return pool;
+  }
+};
+
+#endif  // UTILS_MEMORY_POOL_H_
@@ -0,0 +1,64 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#include "utils/random.h"
+
+#include <nucleus/logging.h>
+
+namespace {
+
+// The multiplier and increment of the PCG32 reference implementation.
+const uint64_t kMultiplier = 6364136223846793005ULL;
+const uint64_t kIncrement = 1442695040888963407ULL;
+
+}  // namespace
+
+Random::Random(uint64_t seed) {
+  this->seed(seed);
+}
+
+Random::~Random() {
+}
+
+void Random::seed(uint64_t seed) {
+  m_state = 0;
+  next();
+  m_state += seed;
+  next();
+}
+
+uint32_t Random::next() {
+  const uint64_t state = m_state;
+  m_state = state * kMultiplier + kIncrement;
+
+  // Output a permutation of the old state: xorshift the high bits down and
+  // rotate by an amount taken from the top bits.
+  const uint32_t xorShifted =
+      static_cast<uint32_t>(((state >> 18u) ^ state) >> 27u);
+  const uint32_t rotation = static_cast<uint32_t>(state >> 59u);
+  return (xorShifted >> rotation) | (xorShifted << ((32u - rotation) & 31u));
+}
+
+int32_t Random::nextInt(int32_t min, int32_t max) {
+  DCHECK(min < max);
+
+  const uint32_t range = static_cast<uint32_t>(max - min);
+  return min + static_cast<int32_t>(next() % range);
+}
+
+float Random::nextFloat(float min, float max) {
+  // Use 24 bits so that every value is exactly representable as a float.
+  const float unit = static_cast<float>(next() >> 8) / 16777216.f;
+  return min + (max - min) * unit;
+}
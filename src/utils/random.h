@@ -0,0 +1,54 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#ifndef UTILS_RANDOM_H_
+#define UTILS_RANDOM_H_
+
+#include <cstdint>
+
+#include <nucleus/macros.h>
+
+// A small random number generator (PCG32) that produces the same sequence for
+// the same seed on every platform and compiler, unlike std::rand and the
+// standard distributions.
+class Random {
+public:
+  explicit Random(uint64_t seed);
+  ~Random();
+
+  // Start the sequence over from the given seed.
+  void seed(uint64_t seed);
+
+  // Get/set the internal state of the generator.  Setting a state returned by
+  // getState continues the sequence from where it was.
+  uint64_t getState() const { return m_state; }
+  void setState(uint64_t state) { m_state = state; }
+
+  // Return the next 32 random bits.
+  uint32_t next();
+
+  // Return a random integer in [min, max).
+  int32_t nextInt(int32_t min, int32_t max);
+
+  // Return a random float in [min, max).
+  float nextFloat(float min, float max);
+
+private:
+  // The current state of the generator.
+  uint64_t m_state{0};
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(Random);
+};
+
+#endif  // UTILS_RANDOM_H_
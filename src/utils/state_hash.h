@@ -0,0 +1,53 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#ifndef UTILS_STATE_HASH_H_
+#define UTILS_STATE_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <SFML/System/Vector2.hpp>
+
+// Builds a 64-bit FNV-1a hash out of the exact bits of the values added to it.
+// Used to check that two runs of the simulation are in the same state.
+class StateHash {
+public:
+  StateHash() = default;
+
+  // Return the hash of everything added so far.
+  uint64_t get() const { return m_hash; }
+
+  // Add the bytes of a value.  Floats are added bit for bit, so even the
+  // smallest difference changes the hash.
+  template <typename T>
+  void add(const T& value) {
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                  "Only plain values can be hashed.");
+    addBytes(&value, sizeof(value));
+  }
+
+  void add(const sf::Vector2f& value) {
+    add(value.x);
+    add(value.y);
+  }
+
+private:
+  void addBytes(const void* data, size_t size);
+
+  uint64_t m_hash{14695981039346656037ULL};
+};
+
+#endif  // UTILS_STATE_HASH_H_
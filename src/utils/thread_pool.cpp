@@ -0,0 +1,95 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#include "utils/thread_pool.h"
+
+ThreadPool::ThreadPool(size_t threadCount) {
+  for (size_t i = 1; i < threadCount; ++i) {
+    m_workers.emplace_back(&ThreadPool::workerMain, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_batchStarted.notify_all();
+
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::run(size_t taskCount,
+                     const std::function<void(size_t)>& task) {
+  // Don't bother waking anyone if there is nothing to share.
+  if (m_workers.empty() || taskCount < 2) {
+    for (size_t i = 0; i < taskCount; ++i) {
+      task(i);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_task = &task;
+    m_taskCount = taskCount;
+    m_nextTask = 0;
+    m_busyWorkers = m_workers.size();
+    ++m_batch;
+  }
+  m_batchStarted.notify_all();
+
+  runTasks();
+
+  // Every worker has to be done with the batch before the task goes away.
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_batchFinished.wait(lock, [this]() { return m_busyWorkers == 0; });
+  m_task = nullptr;
+}
+
+void ThreadPool::workerMain() {
+  uint64_t lastBatch = 0;
+
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_batchStarted.wait(lock, [this, lastBatch]() {
+        return m_stopping || m_batch != lastBatch;
+      });
+      if (m_stopping) {
+        return;
+      }
+      lastBatch = m_batch;
+    }
+
+    runTasks();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (--m_busyWorkers == 0) {
+      m_batchFinished.notify_one();
+    }
+  }
+}
+
+void ThreadPool::runTasks() {
+  for (;;) {
+    const size_t index = m_nextTask.fetch_add(1);
+    if (index >= m_taskCount) {
+      return;
+    }
+    (*m_task)(index);
+  }
+}
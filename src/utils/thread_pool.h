@@ -0,0 +1,84 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#ifndef UTILS_THREAD_POOL_H_
+#define UTILS_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <nucleus/macros.h>
+
+// A fixed set of threads that run batches of tasks.  The thread that starts a
+// batch works on it too, and every thread keeps taking the next unclaimed task
+// until there are none left, so threads that finish early pick up the slack of
+// slower ones.
+class ThreadPool {
+public:
+  // Create a pool that runs tasks on threadCount threads, including the one
+  // that calls run.  A pool with a single thread runs everything inline.
+  explicit ThreadPool(size_t threadCount);
+  ~ThreadPool();
+
+  // Return the number of threads that run tasks, including the caller.
+  size_t getThreadCount() const { return m_workers.size() + 1; }
+
+  // Call task once for every index in [0, taskCount) and return when all of
+  // them are done.  Tasks may run in any order and on any thread.
+  void run(size_t taskCount, const std::function<void(size_t)>& task);
+
+private:
+  // The loop each worker thread runs until the pool is destroyed.
+  void workerMain();
+
+  // Run tasks from the current batch until there are none left.
+  void runTasks();
+
+  // The worker threads.
+  std::vector<std::thread> m_workers;
+
+  // Guards everything below except m_nextTask.
+  std::mutex m_mutex;
+
+  // Signalled when a new batch starts or the pool is being destroyed.
+  std::condition_variable m_batchStarted;
+
+  // Signalled when the last worker finished with the current batch.
+  std::condition_variable m_batchFinished;
+
+  // The current batch.
+  const std::function<void(size_t)>* m_task{nullptr};
+  size_t m_taskCount{0};
+
+  // The index of the next task that hasn't been claimed yet.
+  std::atomic<size_t> m_nextTask{0};
+
+  // Bumped for every batch so that workers know there is new work.
+  uint64_t m_batch{0};
+
+  // The number of workers still busy with the current batch.
+  size_t m_busyWorkers{0};
+
+  // Set when the pool is being destroyed.
+  bool m_stopping{false};
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(ThreadPool);
+};
+
+#endif  // UTILS_THREAD_POOL_H_
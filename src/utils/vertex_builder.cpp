@@ -0,0 +1,150 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#include "utils/vertex_builder.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "utils/math.h"
+
+void appendTriangle(const sf::Transform& transform, const sf::Vector2f& a,
+                    const sf::Vector2f& b, const sf::Vector2f& c,
+                    const sf::Color& color, sf::VertexArray* vertices) {
+  vertices->append(sf::Vertex{transform.transformPoint(a), color});
+  vertices->append(sf::Vertex{transform.transformPoint(b), color});
+  vertices->append(sf::Vertex{transform.transformPoint(c), color});
+}
+
+void appendRectangle(const sf::Transform& transform, const sf::FloatRect& rect,
+                     const sf::Color& color, sf::VertexArray* vertices) {
+  const float right = rect.left + rect.width;
+  const float bottom = rect.top + rect.height;
+
+  const sf::Vertex topLeft{transform.transformPoint(rect.left, rect.top),
+                           color};
+  const sf::Vertex topRight{transform.transformPoint(right, rect.top), color};
+  const sf::Vertex bottomLeft{transform.transformPoint(rect.left, bottom),
+                              color};
+  const sf::Vertex bottomRight{transform.transformPoint(right, bottom), color};
+
+  vertices->append(topLeft);
+  vertices->append(topRight);
+  vertices->append(bottomLeft);
+
+  vertices->append(bottomLeft);
+  vertices->append(topRight);
+  vertices->append(bottomRight);
+}
+
+void appendQuad(const std::array<sf::Vector2f, 4>& corners,
+                const sf::Color& color, sf::VertexArray* vertices) {
+  vertices->append(sf::Vertex{corners[0], color});
+  vertices->append(sf::Vertex{corners[1], color});
+  vertices->append(sf::Vertex{corners[3], color});
+
+  vertices->append(sf::Vertex{corners[3], color});
+  vertices->append(sf::Vertex{corners[1], color});
+  vertices->append(sf::Vertex{corners[2], color});
+}
+
+void appendTexturedRectangle(const sf::Transform& transform,
+                             const sf::FloatRect& rect,
+                             const sf::IntRect& textureRect,
+                             sf::VertexArray* vertices) {
+  const float right = rect.left + rect.width;
+  const float bottom = rect.top + rect.height;
+
+  const float textureLeft = static_cast<float>(textureRect.left);
+  const float textureTop = static_cast<float>(textureRect.top);
+  const float textureRight = textureLeft + textureRect.width;
+  const float textureBottom = textureTop + textureRect.height;
+
+  const sf::Color color{255, 255, 255, 255};
+
+  const sf::Vertex topLeft{transform.transformPoint(rect.left, rect.top),
+                           color, sf::Vector2f{textureLeft, textureTop}};
+  const sf::Vertex topRight{transform.transformPoint(right, rect.top), color,
+                            sf::Vector2f{textureRight, textureTop}};
+  const sf::Vertex bottomLeft{transform.transformPoint(rect.left, bottom),
+                              color, sf::Vector2f{textureLeft, textureBottom}};
+  const sf::Vertex bottomRight{transform.transformPoint(right, bottom), color,
+                               sf::Vector2f{textureRight, textureBottom}};
+
+  vertices->append(topLeft);
+  vertices->append(topRight);
+  vertices->append(bottomLeft);
+
+  vertices->append(bottomLeft);
+  vertices->append(topRight);
+  vertices->append(bottomRight);
+}
+
+void appendCircle(const sf::Vector2f& center, float radius,
+                  const sf::Color& color, sf::VertexArray* vertices,
+                  size_t segmentCount) {
+  // Walk around the circle by rotating the edge point by a fixed step, so
+  // that we only need one sin and cos per circle.
+  const float step = 2.f * kPi / static_cast<float>(segmentCount);
+  const float stepCos = std::cos(step);
+  const float stepSin = std::sin(step);
+
+  sf::Vector2f edge{radius, 0.f};
+  for (size_t i = 0; i < segmentCount; ++i) {
+    const sf::Vector2f next{edge.x * stepCos - edge.y * stepSin,
+                            edge.x * stepSin + edge.y * stepCos};
+
+    vertices->append(sf::Vertex{center, color});
+    vertices->append(sf::Vertex{center + edge, color});
+    vertices->append(sf::Vertex{center + next, color});
+
+    edge = next;
+  }
+}
+
+CachedLineQuad::CachedLineQuad(float nearOffset, float farOffset)
+  : m_nearOffset(nearOffset), m_farOffset(farOffset) {
+}
+
+void CachedLineQuad::placeAlong(const sf::Vector2f& start,
+                                const sf::Vector2f& end) {
+  if (m_isPlaced && start == m_start && end == m_end) {
+    return;
+  }
+
+  sf::Transform transform;
+  transform.translate(start);
+  transform.rotate(directionBetween(start, end));
+  const float length = distanceBetween(start, end);
+  m_corners = {{transform.transformPoint(0.f, m_nearOffset),
+                transform.transformPoint(length, m_nearOffset),
+                transform.transformPoint(length, m_farOffset),
+                transform.transformPoint(0.f, m_farOffset)}};
+
+  float left = m_corners[0].x;
+  float top = m_corners[0].y;
+  float right = left;
+  float bottom = top;
+  for (const auto& corner : m_corners) {
+    left = std::min(left, corner.x);
+    top = std::min(top, corner.y);
+    right = std::max(right, corner.x);
+    bottom = std::max(bottom, corner.y);
+  }
+  m_bounds = sf::FloatRect{left, top, right - left, bottom - top};
+
+  m_start = start;
+  m_end = end;
+  m_isPlaced = true;
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+#ifndef UTILS_VERTEX_BUILDER_H_
+#define UTILS_VERTEX_BUILDER_H_
+
+#include <array>
+#include <cstddef>
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+// Functions that add the triangles for simple shapes to a vertex array, so
+// that many shapes can be drawn with a single draw call.  All the shapes are
+// given in local coordinates and moved into place with the transform.
+
+// Add a single triangle.
+void appendTriangle(const sf::Transform& transform, const sf::Vector2f& a,
+                    const sf::Vector2f& b, const sf::Vector2f& c,
+                    const sf::Color& color, sf::VertexArray* vertices);
+
+// Add a filled rectangle.
+void appendRectangle(const sf::Transform& transform, const sf::FloatRect& rect,
+                     const sf::Color& color, sf::VertexArray* vertices);
+
+// Add a filled quad with corners that are already in place, given in order
+// around the quad.
+void appendQuad(const std::array<sf::Vector2f, 4>& corners,
+                const sf::Color& color, sf::VertexArray* vertices);
+
+// Add a rectangle that shows the textureRect part of a texture.  The vertices
+// have to be drawn with that texture.
+void appendTexturedRectangle(const sf::Transform& transform,
+                             const sf::FloatRect& rect,
+                             const sf::IntRect& textureRect,
+                             sf::VertexArray* vertices);
+
+// Add a filled circle made up of segmentCount triangles.
+void appendCircle(const sf::Vector2f& center, float radius,
+                  const sf::Color& color, sf::VertexArray* vertices,
+                  size_t segmentCount = 30);
+
+// A quad running alongside the line between two points, like a power link or
+// a mining laser.  The things at the ends hardly ever move, so the corners are
+// kept between frames and only calculated again when the end points change.
+class CachedLineQuad {
+public:
+  // The quad covers the band from nearOffset to farOffset across the line,
+  // where positive offsets are to the right when looking from the start to
+  // the end.
+  CachedLineQuad(float nearOffset, float farOffset);
+
+  // Place the quad along the line from start to end.
+  void placeAlong(const sf::Vector2f& start, const sf::Vector2f& end);
+
+  // Return the corners of the quad in order around it, and the bounds around
+  // them.
+  const std::array<sf::Vector2f, 4>& getCorners() const { return m_corners; }
+  const sf::FloatRect& getBounds() const { return m_bounds; }
+
+private:
+  float m_nearOffset;
+  float m_farOffset;
+
+  // The end points the corners were last calculated for.
+  sf::Vector2f m_start;
+  sf::Vector2f m_end;
+  bool m_isPlaced{false};
+
+  std::array<sf::Vector2f, 4> m_corners;
+  sf::FloatRect m_bounds;
+};
+
+#endif  // UTILS_VERTEX_BUILDER_H_
@@ -0,0 +1,859 @@
+// Copyright (c) 2015, Tiaan Louw
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+// REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+// INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+// LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR
+// OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR
+// PERFORMANCE OF THIS SOFTWARE.
+
+// Runs the universe without a window or a graphics context and steps it as
+// fast as possible, so that the simulation can be measured and soak tested on
+// machines without a display.
+//
+// Usage: SpaceGameSim [--ticks=N] [--adjustment=A] [--spawn-interval=N]
+//                     [--seed=N] [--threads=N] [--hash-interval=N]
+//                     [--scaling] [--record=PATH] [--replay=PATH]
+//                     [--timing=PATH] [--save-snapshot=PATH]
+//                     [--load-snapshot=PATH] [--collision-benchmark]
+//                     [--spatial-benchmark] [--projectile-benchmark]
+//
+// A hash of the universe state is printed at the end, and every N ticks with
+// --hash-interval, so that runs can be compared tick by tick.  The number of
+// heap allocations made while ticking is printed as well, which should be zero
+// once the run has settled.
+// With --scaling the same run is repeated on 1, 2, 4 and 8 threads and the
+// speedup over a single thread is reported for each.
+// With --record every object placed during the run is written to a command
+// log, which --replay feeds back into a new universe instead of building the
+// default scenario.  A log recorded by the game with --record can be replayed
+// the same way.  --timing writes how long every tick took to a CSV file.
+// --save-snapshot writes the state of the universe at the end of the run, and
+// --load-snapshot starts the run from a saved state instead of building the
+// default scenario, so large stress scenarios only have to be built once.
+// --collision-benchmark compares finding what 10k projectiles hit among 1k
+// structures one projectile at a time with the projectile system's single
+// batched pass.  --spatial-benchmark compares radius and closest object
+// queries against a walk over every object, at 1k, 10k and 100k objects.
+// --projectile-benchmark ticks a universe with 100k bullets in flight for a
+// second at 60 ticks per second and reports how much of the tick budget that
+// takes.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "game/resource_manager.h"
+#include "universe/command_log.h"
+#include "universe/objects/projectiles/bullet.h"
+#include "universe/universe.h"
+#include "utils/math.h"
+#include "utils/random.h"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+// Every allocation made on the heap, counted by the operator new below.  The
+// memory pools only count their own allocations, so this is what shows
+// whether a tick allocates at all.
+std::atomic<size_t> s_heapAllocationCount{0};
+
+}  // namespace
+
+void* operator new(size_t size) {
+  ++s_heapAllocationCount;
+  void* memory = std::malloc(size ? size : 1);
+  if (!memory) {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+
+// With sized deallocation the compiler calls this one instead, so it has to
+// be replaced as well to pair up with the operator new above.
+void operator delete(void* memory, size_t) noexcept {
+  std::free(memory);
+}
+
+namespace {
+
+struct Options {
+  // The number of ticks to run.
+  size_t ticks{10000};
+
+  // The adjustment passed to every tick.  1.0 is a tick at 60 fps.
+  float adjustment{1.f};
+
+  // Spawn an enemy ship every this many ticks.  0 disables spawning.
+  size_t spawnInterval{30};
+
+  // The seed of the universe.
+  uint64_t seed{1};
+
+  // The number of threads the universe ticks objects on.
+  size_t threads{1};
+
+  // Print the state hash every this many ticks.  0 only prints the final
+  // hash.
+  size_t hashInterval{0};
+
+  // Run on 1, 2, 4 and 8 threads and compare them.
+  bool scaling{false};
+
+  // Compare per projectile collision queries with the batched pass.
+  bool collisionBenchmark{false};
+
+  // Compare spatial queries with walking every object.
+  bool spatialBenchmark{false};
+
+  // Measure ticking a universe full of bullets.
+  bool projectileBenchmark{false};
+
+  // Write the objects placed during the run to this command log.
+  std::string recordPath;
+
+  // Replay the objects placed in this command log instead of building the
+  // default scenario.
+  std::string replayPath;
+
+  // Write the time every tick took to this CSV file.
+  std::string timingPath;
+
+  // Write a snapshot of the universe at the end of the run to this file.
+  std::string saveSnapshotPath;
+
+  // Start from the snapshot in this file instead of building the default
+  // scenario.
+  std::string loadSnapshotPath;
+};
+
+// What a run starts from and what it keeps.
+struct Scenario {
+  // Place the objects in this log at the ticks they were recorded at instead
+  // of building the default scenario.
+  const CommandLog* replay{nullptr};
+
+  // Start from this snapshot instead of building the default scenario.
+  const std::string* snapshot{nullptr};
+
+  // Record every placed object into this log.
+  CommandLog* record{nullptr};
+
+  // Store a snapshot of the universe at the end of the run here.
+  std::string* finalSnapshot{nullptr};
+};
+
+// How long a single tick took.
+struct TickTiming {
+  double microseconds;
+  size_t objectCount;
+};
+
+// What we measured during a run.
+struct Result {
+  double seconds{0.0};
+  size_t peakObjectCount{0};
+  size_t finalObjectCount{0};
+  int32_t finalMinerals{0};
+  uint64_t finalStateHash{0};
+  std::vector<TickTiming> tickTimings;
+
+  // Heap allocations made while ticking, over the whole run and over the
+  // second half, by when the pools and buffers should have stopped growing.
+  size_t heapAllocations{0};
+  size_t steadyHeapAllocations{0};
+};
+
+// Parse a single "--name=value" argument into options.  Returns false if the
+// argument is not recognized.
+bool parseArgument(const std::string& arg, Options* options) {
+  if (arg == "--scaling") {
+    options->scaling = true;
+    return true;
+  }
+
+  if (arg == "--collision-benchmark") {
+    options->collisionBenchmark = true;
+    return true;
+  }
+
+  if (arg == "--spatial-benchmark") {
+    options->spatialBenchmark = true;
+    return true;
+  }
+
+  if (arg == "--projectile-benchmark") {
+    options->projectileBenchmark = true;
+    return true;
+  }
+
+  size_t equals = arg.find('=');
+  if (arg.compare(0, 2, "--") != 0 || equals == std::string::npos) {
+    return false;
+  }
+
+  std::string name = arg.substr(2, equals - 2);
+  std::string value = arg.substr(equals + 1);
+
+  if (name == "ticks") {
+    options->ticks = std::strtoul(value.c_str(), nullptr, 10);
+  } else if (name == "adjustment") {
+    options->adjustment = std::strtof(value.c_str(), nullptr);
+  } else if (name == "spawn-interval") {
+    options->spawnInterval = std::strtoul(value.c_str(), nullptr, 10);
+  } else if (name == "seed") {
+    options->seed = std::strtoull(value.c_str(), nullptr, 10);
+  } else if (name == "threads") {
+    options->threads = std::strtoul(value.c_str(), nullptr, 10);
+  } else if (name == "hash-interval") {
+    options->hashInterval = std::strtoul(value.c_str(), nullptr, 10);
+  } else if (name == "record") {
+    options->recordPath = value;
+  } else if (name == "replay") {
+    options->replayPath = value;
+  } else if (name == "timing") {
+    options->timingPath = value;
+  } else if (name == "save-snapshot") {
+    options->saveSnapshotPath = value;
+  } else if (name == "load-snapshot") {
+    options->loadSnapshotPath = value;
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+// Return the peak resident set size of the process in kilobytes.
+size_t getPeakResidentSetSize() {
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters,
+                            sizeof(counters))) {
+    return 0;
+  }
+  return counters.PeakWorkingSetSize / 1024;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#if defined(__APPLE__)
+  // macOS reports bytes instead of kilobytes.
+  return static_cast<size_t>(usage.ru_maxrss) / 1024;
+#else
+  return static_cast<size_t>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+// Build a base around the command center: a ring of power relays, each with a
+// turret and a miner next to it.
+void buildBase(Universe* universe) {
+  const size_t kRelayCount = 8;
+  const float kRelayDistance = 1000.f;
+
+  for (size_t i = 0; i < kRelayCount; ++i) {
+    float direction = 360.f * static_cast<float>(i) / kRelayCount;
+    sf::Vector2f relayPos = vectorInDirection(direction, kRelayDistance);
+
+    sf::Vector2f turretPos =
+        relayPos + vectorInDirection(direction + 90.f, 300.f);
+    sf::Vector2f minerPos =
+        relayPos + vectorInDirection(direction - 90.f, 300.f);
+
+    universe->placeObject(ObjectType::PowerRelay, relayPos);
+    universe->placeObject(ObjectType::Turret, turretPos);
+    universe->placeObject(ObjectType::Miner, minerPos);
+  }
+}
+
+// Spawn an enemy ship somewhere on a circle well outside of the base.  The
+// direction comes from the spawner's own generator and not the universe's, so
+// that a replay, which places the ship without choosing a direction, leaves
+// the universe's generator in the same state.
+void spawnEnemyShip(Universe* universe, Random* spawner) {
+  float direction = spawner->nextFloat(0.f, 360.f);
+  universe->placeObject(ObjectType::EnemyShip,
+                        vectorInDirection(direction, 4000.f));
+}
+
+// Build a universe from the scenario, run it for the number of ticks in
+// options and measure how long it took.
+Result runSimulation(const Options& options, size_t threads, bool printHashes,
+                     const Scenario& scenario) {
+  // We don't load any resources, so nothing touches the graphics driver.
+  // Objects just end up without textures and fonts.
+  ResourceManager resourceManager;
+  Universe universe{&resourceManager, options.seed};
+  universe.setThreadCount(threads);
+
+  CommandLog* record = scenario.record;
+  if (record) {
+    record->clear();
+    record->setSeed(options.seed);
+    record->setAdjustment(options.adjustment);
+    universe.setCommandLog(record);
+  }
+
+  // The snapshot was already checked when it was read from disk.
+  if (scenario.snapshot) {
+    std::istringstream stream{*scenario.snapshot};
+    universe.loadSnapshot(&stream);
+  }
+
+  const CommandLog* replay = scenario.replay;
+  Random spawner{options.seed};
+  if (!replay && !scenario.snapshot) {
+    buildBase(&universe);
+  }
+
+  Result result;
+  result.peakObjectCount = universe.getObjectCount();
+  result.tickTimings.reserve(options.ticks);
+
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+
+  size_t nextCommand = 0;
+  for (size_t tick = 0; tick < options.ticks; ++tick) {
+    if (replay) {
+      const auto& commands = replay->getCommands();
+      for (; nextCommand < commands.size() &&
+                 commands[nextCommand].tick <= universe.getTickCount();
+           ++nextCommand) {
+        universe.placeObject(commands[nextCommand].objectType,
+                             commands[nextCommand].pos);
+      }
+    } else if (options.spawnInterval && tick % options.spawnInterval == 0) {
+      spawnEnemyShip(&universe, &spawner);
+    }
+
+    const size_t allocationsBefore = s_heapAllocationCount;
+    const auto tickStart = Clock::now();
+    universe.tick(options.adjustment);
+    const std::chrono::duration<double, std::micro> tickElapsed =
+        Clock::now() - tickStart;
+
+    const size_t allocations = s_heapAllocationCount - allocationsBefore;
+    result.heapAllocations += allocations;
+    if (tick >= options.ticks / 2) {
+      result.steadyHeapAllocations += allocations;
+    }
+    result.tickTimings.push_back(
+        TickTiming{tickElapsed.count(), universe.getObjectCount()});
+
+    result.peakObjectCount =
+        std::max(result.peakObjectCount, universe.getObjectCount());
+
+    if (printHashes && options.hashInterval &&
+        universe.getTickCount() % options.hashInterval == 0) {
+      std::cout << "tick " << universe.getTickCount() << " hash " << std::hex
+                << universe.calculateStateHash() << std::dec << std::endl;
+    }
+  }
+
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+  result.seconds = elapsed.count();
+  result.finalObjectCount = universe.getObjectCount();
+  result.finalMinerals = universe.getMinerals();
+  result.finalStateHash = universe.calculateStateHash();
+
+  universe.setCommandLog(nullptr);
+
+  if (scenario.finalSnapshot) {
+    std::ostringstream stream;
+    universe.saveSnapshot(&stream);
+    *scenario.finalSnapshot = stream.str();
+  }
+
+  return result;
+}
+
+// Write the timing of every tick to a CSV file.  Returns false if the file
+// could not be written.
+bool writeTickTimings(const std::string& path, const Result& result) {
+  std::ofstream file{path};
+  if (!file) {
+    return false;
+  }
+
+  file << "tick,microseconds,objects\n";
+  for (size_t i = 0; i < result.tickTimings.size(); ++i) {
+    file << i << ',' << result.tickTimings[i].microseconds << ','
+         << result.tickTimings[i].objectCount << '\n';
+  }
+
+  return static_cast<bool>(file);
+}
+
+// Print the mean, median, 95th percentile and slowest tick of a run.
+void printTickTimingSummary(const Result& result) {
+  if (result.tickTimings.empty()) {
+    return;
+  }
+
+  std::vector<double> sorted;
+  sorted.reserve(result.tickTimings.size());
+  double total = 0.0;
+  for (const auto& timing : result.tickTimings) {
+    sorted.push_back(timing.microseconds);
+    total += timing.microseconds;
+  }
+  std::sort(std::begin(sorted), std::end(sorted));
+
+  auto percentile = [&sorted](double fraction) {
+    return sorted[static_cast<size_t>(fraction * (sorted.size() - 1))];
+  };
+
+  std::cout << "tick mean (us): " << total / sorted.size() << std::endl;
+  std::cout << "tick p50 (us): " << percentile(0.5) << std::endl;
+  std::cout << "tick p95 (us): " << percentile(0.95) << std::endl;
+  std::cout << "tick max (us): " << sorted.back() << std::endl;
+}
+
+// Return the number of ticks per second of a run.
+double ticksPerSecond(const Options& options, const Result& result) {
+  return result.seconds > 0.0 ? options.ticks / result.seconds : 0.0;
+}
+
+// Run the same simulation on more and more threads and print how much faster
+// each is than a single thread.  Every run should end in the same state.
+int runScalingBenchmark(const Options& options, const Scenario& scenario) {
+  const size_t kThreadCounts[] = {1, 2, 4, 8};
+
+  std::cout << "threads  ticks/s  speedup  final state hash" << std::endl;
+
+  Result baseline;
+  bool consistent = true;
+  for (size_t threads : kThreadCounts) {
+    const Result result =
+        runSimulation(options, threads, false, scenario);
+    if (threads == 1) {
+      baseline = result;
+    }
+
+    const double speedup =
+        result.seconds > 0.0 ? baseline.seconds / result.seconds : 0.0;
+    std::cout << threads << "  " << ticksPerSecond(options, result) << "  "
+              << speedup << "  " << std::hex << result.finalStateHash
+              << std::dec << std::endl;
+
+    if (result.finalStateHash != baseline.finalStateHash) {
+      consistent = false;
+    }
+  }
+
+  if (!consistent) {
+    std::cerr << "The runs did not end in the same state." << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+// Scatter 10k bullets among 1k power relays and find what the bullets hit,
+// first by querying the universe for every bullet the way bullets used to and
+// then with a single batched pass of the projectile system.
+int runCollisionBenchmark(const Options& options) {
+  const size_t kTargetCount = 1000;
+  const size_t kProjectileCount = 10000;
+  const float kFieldSize = 20000.f;
+  const size_t kRepeatCount = 100;
+
+  ResourceManager resourceManager;
+  Universe universe{&resourceManager, options.seed};
+  Random random{options.seed};
+
+  ProjectileSystem::Targets targets;
+  std::vector<Object*>& relays =
+      targets[static_cast<size_t>(ObjectType::PowerRelay)];
+  for (size_t i = 0; i < kTargetCount; ++i) {
+    sf::Vector2f pos{random.nextFloat(0.f, kFieldSize),
+                     random.nextFloat(0.f, kFieldSize)};
+    relays.push_back(universe.placeObject(ObjectType::PowerRelay, pos));
+  }
+
+  std::vector<Bullet*> bullets;
+  for (size_t i = 0; i < kProjectileCount; ++i) {
+    sf::Vector2f pos{random.nextFloat(0.f, kFieldSize),
+                     random.nextFloat(0.f, kFieldSize)};
+    bullets.push_back(static_cast<Bullet*>(universe.addObject(
+        std::make_unique<Bullet>(&universe, pos,
+                                 random.nextFloat(0.f, 360.f), 20.f))));
+  }
+
+  // Move the bullets once, so that every one of them has a path to sweep.
+  ProjectileSystem* projectileSystem = universe.getProjectileSystem();
+  std::vector<Projectile*> expired;
+  projectileSystem->tick(options.adjustment, &expired);
+
+  using Clock = std::chrono::steady_clock;
+
+  size_t queryHits = 0;
+  std::vector<Object*> possibles;
+  auto start = Clock::now();
+  for (size_t repeat = 0; repeat < kRepeatCount; ++repeat) {
+    queryHits = 0;
+    for (const auto& bullet : bullets) {
+      possibles.clear();
+      universe.findObjectsInRadius(Object::objectTypesForStructures(),
+                                   bullet->getPos(),
+                                   ProjectileSystem::kHitRadius, &possibles);
+      if (!possibles.empty()) {
+        ++queryHits;
+      }
+    }
+  }
+  const std::chrono::duration<double, std::micro> queryElapsed =
+      Clock::now() - start;
+
+  std::vector<ProjectileSystem::Collision> collisions;
+  start = Clock::now();
+  for (size_t repeat = 0; repeat < kRepeatCount; ++repeat) {
+    collisions.clear();
+    projectileSystem->findCollisions(targets, &collisions);
+  }
+  const std::chrono::duration<double, std::micro> batchElapsed =
+      Clock::now() - start;
+
+  std::cout << "projectiles: " << kProjectileCount << std::endl;
+  std::cout << "targets: " << kTargetCount << std::endl;
+  std::cout << "per projectile queries (us): "
+            << queryElapsed.count() / kRepeatCount << std::endl;
+  std::cout << "per projectile query hits: " << queryHits << std::endl;
+  std::cout << "batched pass (us): " << batchElapsed.count() / kRepeatCount
+            << std::endl;
+  std::cout << "batched pass hits: " << collisions.size() << std::endl;
+
+  return 0;
+}
+
+// Fill universes with 1k, 10k and 100k enemy ships at the same density and
+// time radius and closest object queries, first by walking every object the
+// way the universe used to and then through the spatial index.
+int runSpatialBenchmark(const Options& options) {
+  const size_t kObjectCounts[] = {1000, 10000, 100000};
+  const size_t kQueryCount = 1000;
+  const float kQueryRadius = 500.f;
+
+  // Every object gets a square of this size to itself on average.
+  const float kSpacing = 100.f;
+
+  using Clock = std::chrono::steady_clock;
+
+  std::cout << "objects  radius walk (us)  radius index (us)  "
+               "closest walk (us)  closest index (us)" << std::endl;
+
+  for (size_t objectCount : kObjectCounts) {
+    ResourceManager resourceManager;
+    Universe universe{&resourceManager, options.seed};
+    Random random{options.seed};
+
+    const float fieldSize = std::sqrt(static_cast<float>(objectCount)) *
+                            kSpacing;
+    std::vector<Object*> objects;
+    objects.reserve(objectCount);
+    for (size_t i = 0; i < objectCount; ++i) {
+      sf::Vector2f pos{random.nextFloat(0.f, fieldSize),
+                       random.nextFloat(0.f, fieldSize)};
+      objects.push_back(universe.placeObject(ObjectType::EnemyShip, pos));
+    }
+
+    std::vector<sf::Vector2f> queries;
+    queries.reserve(kQueryCount);
+    for (size_t i = 0; i < kQueryCount; ++i) {
+      queries.push_back(sf::Vector2f{random.nextFloat(0.f, fieldSize),
+                                     random.nextFloat(0.f, fieldSize)});
+    }
+
+    // The results are added up, so that none of the queries can be skipped
+    // and so that the walks can be checked against the index.
+    size_t walkFound = 0;
+    std::vector<Object*> found;
+    auto start = Clock::now();
+    for (const auto& query : queries) {
+      found.clear();
+      for (const auto& object : objects) {
+        if (object->calculateDistanceFrom(query) <= kQueryRadius) {
+          found.push_back(object);
+        }
+      }
+      walkFound += found.size();
+    }
+    const std::chrono::duration<double, std::micro> radiusWalk =
+        Clock::now() - start;
+
+    size_t indexFound = 0;
+    start = Clock::now();
+    for (const auto& query : queries) {
+      found.clear();
+      universe.findObjectsInRadius(ObjectType::EnemyShip, query, kQueryRadius,
+                                   &found);
+      indexFound += found.size();
+    }
+    const std::chrono::duration<double, std::micro> radiusIndex =
+        Clock::now() - start;
+
+    double walkDistance = 0.0;
+    start = Clock::now();
+    for (const auto& query : queries) {
+      float closestDistance = std::numeric_limits<float>::max();
+      for (const auto& object : objects) {
+        closestDistance =
+            std::min(closestDistance, object->calculateDistanceFrom(query));
+      }
+      walkDistance += closestDistance;
+    }
+    const std::chrono::duration<double, std::micro> closestWalk =
+        Clock::now() - start;
+
+    double indexDistance = 0.0;
+    start = Clock::now();
+    for (const auto& query : queries) {
+      Object* closest =
+          universe.findClosestObjectOfType(query, ObjectType::EnemyShip);
+      if (closest) {
+        indexDistance += closest->calculateDistanceFrom(query);
+      }
+    }
+    const std::chrono::duration<double, std::micro> closestIndex =
+        Clock::now() - start;
+
+    std::cout << objectCount << "  " << radiusWalk.count() / kQueryCount
+              << "  " << radiusIndex.count() / kQueryCount << "  "
+              << closestWalk.count() / kQueryCount << "  "
+              << closestIndex.count() / kQueryCount << std::endl;
+
+    if (walkFound != indexFound || walkDistance != indexDistance) {
+      std::cerr << "The index found different objects than the walk."
+                << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+// Fire 100k bullets in random directions, away from the structures so that
+// they stay in flight, and tick the universe for one second at 60 ticks per
+// second.
+int runProjectileBenchmark(const Options& options) {
+  const size_t kProjectileCount = 100000;
+  const size_t kTickCount = 60;
+  const float kFieldMin = 10000.f;
+  const float kFieldMax = 50000.f;
+
+  // Slow enough that no bullet goes out of range during the run.
+  const float kSpeed = 5.f;
+
+  // The time one tick may take when ticking 60 times per second.
+  const double kTickBudget = 1000.0 / 60.0;
+
+  ResourceManager resourceManager;
+  Universe universe{&resourceManager, options.seed};
+  universe.setThreadCount(options.threads);
+  Random random{options.seed};
+
+  for (size_t i = 0; i < kProjectileCount; ++i) {
+    sf::Vector2f pos{random.nextFloat(kFieldMin, kFieldMax),
+                     random.nextFloat(kFieldMin, kFieldMax)};
+    universe.addObject(std::make_unique<Bullet>(
+        &universe, pos, random.nextFloat(0.f, 360.f), kSpeed));
+  }
+
+  using Clock = std::chrono::steady_clock;
+
+  double totalTime = 0.0;
+  double maxTime = 0.0;
+  for (size_t tick = 0; tick < kTickCount; ++tick) {
+    const auto start = Clock::now();
+    universe.tick(1.f);
+    const std::chrono::duration<double, std::milli> elapsed =
+        Clock::now() - start;
+
+    totalTime += elapsed.count();
+    maxTime = std::max(maxTime, elapsed.count());
+  }
+
+  const double averageTime = totalTime / kTickCount;
+  std::cout << "projectiles: "
+            << universe.getProjectileSystem()->getProjectileCount()
+            << std::endl;
+  std::cout << "average tick (ms): " << averageTime << std::endl;
+  std::cout << "slowest tick (ms): " << maxTime << std::endl;
+  std::cout << "60 Hz budget used: " << averageTime / kTickBudget * 100.0
+            << "%" << std::endl;
+
+  return 0;
+}
+
+// Read a snapshot from a file and check that it loads.  Prints how long
+// loading took, because that is what matters for large scenarios.
+bool readSnapshot(const std::string& path, std::string* snapshotOut) {
+  std::ifstream file{path, std::ios::binary};
+  if (!file) {
+    return false;
+  }
+  snapshotOut->assign(std::istreambuf_iterator<char>{file},
+                      std::istreambuf_iterator<char>{});
+
+  ResourceManager resourceManager;
+  Universe universe{&resourceManager, 0};
+
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  std::istringstream stream{*snapshotOut};
+  if (!universe.loadSnapshot(&stream)) {
+    return false;
+  }
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+  std::cout << "snapshot objects: " << universe.getObjectCount() << std::endl;
+  std::cout << "snapshot load seconds: " << elapsed.count() << std::endl;
+
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    if (!parseArgument(argv[i], &options)) {
+      std::cerr << "Unknown argument: " << argv[i] << std::endl;
+      std::cerr << "Usage: SpaceGameSim [--ticks=N] [--adjustment=A] "
+                   "[--spawn-interval=N] [--seed=N] [--threads=N] "
+                   "[--hash-interval=N] [--scaling] [--record=PATH] "
+                   "[--replay=PATH] [--timing=PATH] [--save-snapshot=PATH] "
+                   "[--load-snapshot=PATH] [--collision-benchmark] "
+                   "[--spatial-benchmark] [--projectile-benchmark]"
+                << std::endl;
+      return 1;
+    }
+  }
+
+  if (options.collisionBenchmark) {
+    return runCollisionBenchmark(options);
+  }
+
+  if (options.spatialBenchmark) {
+    return runSpatialBenchmark(options);
+  }
+
+  if (options.projectileBenchmark) {
+    return runProjectileBenchmark(options);
+  }
+
+  // A replay runs with the seed and adjustment it was recorded with.
+  CommandLog replay;
+  if (!options.replayPath.empty()) {
+    if (!replay.loadFromFile(options.replayPath)) {
+      std::cerr << "Could not load command log: " << options.replayPath
+                << std::endl;
+      return 1;
+    }
+    options.seed = replay.getSeed();
+    options.adjustment = replay.getAdjustment();
+  }
+
+  std::string snapshot;
+  if (!options.loadSnapshotPath.empty() &&
+      !readSnapshot(options.loadSnapshotPath, &snapshot)) {
+    std::cerr << "Could not load snapshot: " << options.loadSnapshotPath
+              << std::endl;
+    return 1;
+  }
+
+  Scenario scenario;
+  if (!options.replayPath.empty()) {
+    scenario.replay = &replay;
+  }
+  if (!options.loadSnapshotPath.empty()) {
+    scenario.snapshot = &snapshot;
+  }
+
+  if (options.scaling) {
+    return runScalingBenchmark(options, scenario);
+  }
+
+  CommandLog record;
+  if (!options.recordPath.empty()) {
+    scenario.record = &record;
+  }
+
+  std::string finalSnapshot;
+  if (!options.saveSnapshotPath.empty()) {
+    scenario.finalSnapshot = &finalSnapshot;
+  }
+
+  const Result result =
+      runSimulation(options, options.threads, true, scenario);
+
+  if (!options.recordPath.empty() && !record.saveToFile(options.recordPath)) {
+    std::cerr << "Could not write command log: " << options.recordPath
+              << std::endl;
+    return 1;
+  }
+
+  if (!options.saveSnapshotPath.empty()) {
+    std::ofstream file{options.saveSnapshotPath, std::ios::binary};
+    if (!file.write(finalSnapshot.data(), finalSnapshot.size())) {
+      std::cerr << "Could not write snapshot: " << options.saveSnapshotPath
+                << std::endl;
+      return 1;
+    }
+  }
+
+  if (!options.timingPath.empty() &&
+      !writeTickTimings(options.timingPath, result)) {
+    std::cerr << "Could not write tick timings: " << options.timingPath
+              << std::endl;
+    return 1;
+  }
+
+  std::cout << "ticks: " << options.ticks << std::endl;
+  std::cout << "threads: " << options.threads << std::endl;
+  std::cout << "seconds: " << result.seconds << std::endl;
+  std::cout << "ticks per second: " << ticksPerSecond(options, result)
+            << std::endl;
+  std::cout << "peak object count: " << result.peakObjectCount << std::endl;
+  std::cout << "final object count: " << result.finalObjectCount << std::endl;
+  std::cout << "final minerals: " << result.finalMinerals << std::endl;
+  std::cout << "final state hash: " << std::hex << result.finalStateHash
+            << std::dec << std::endl;
+  printTickTimingSummary(result);
+  std::cout << "heap allocations while ticking: " << result.heapAllocations
+            << " (" << result.steadyHeapAllocations << " in the second half)"
+            << std::endl;
+  std::cout << "peak rss (KB): " << getPeakResidentSetSize() << std::endl;
+
+  return 0;
+}